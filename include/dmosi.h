@@ -19,6 +19,17 @@
  */
 #define DMOSI_SYSTEM_MODULE_NAME    "system"
 
+/**
+ * @brief Declare an opaque, suitably aligned storage type of a given size
+ *
+ * Used for the caller-provided control blocks of the _create_static
+ * functions. The storage is an array of uint64_t so that it satisfies the
+ * alignment requirements of any backend control block.
+ *
+ * @param size Minimum size of the storage in bytes
+ */
+#define DMOSI_STATIC_STORAGE(size)  struct { uint64_t opaque[((size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)]; }
+
 //==============================================================================
 //                              Initialization API
 //==============================================================================
@@ -84,6 +95,41 @@ typedef struct dmosi_mutex* dmosi_mutex_t;
  */
 DMOD_BUILTIN_API( dmosi, 1.0, dmosi_mutex_t, _mutex_create,    (bool recursive) );
 
+/**
+ * @brief Mutex priority protocol
+ */
+typedef enum {
+    DMOSI_MUTEX_PROTOCOL_NONE,      /**< No priority adjustment beyond the backend's native behavior */
+    DMOSI_MUTEX_PROTOCOL_INHERIT,   /**< Priority inheritance: the owner runs at the priority of its highest-priority waiter */
+    DMOSI_MUTEX_PROTOCOL_CEILING    /**< Priority ceiling: the owner runs at dmosi_mutex_attr_t::ceiling_priority while holding the mutex */
+} dmosi_mutex_protocol_t;
+
+/**
+ * @brief Mutex creation attributes
+ *
+ * Initialize with DMOSI_MUTEX_ATTR_DEFAULT and change only the fields
+ * that matter, so code keeps working if fields are added later.
+ */
+typedef struct {
+    bool                   recursive;          /**< Whether the mutex should be recursive */
+    dmosi_mutex_protocol_t protocol;           /**< Priority protocol */
+    int                    ceiling_priority;   /**< Ceiling priority, used with DMOSI_MUTEX_PROTOCOL_CEILING only */
+    uint32_t               spin_count;         /**< Busy-wait attempts before blocking on SMP targets (0 = block straight away); a hint only */
+} dmosi_mutex_attr_t;
+
+/**
+ * @brief Default mutex attributes - same behavior as dmosi_mutex_create(false)
+ */
+#define DMOSI_MUTEX_ATTR_DEFAULT    { false, DMOSI_MUTEX_PROTOCOL_NONE, 0, 0 }
+
+/**
+ * @brief Create a mutex with creation attributes
+ *
+ * @param attr Mutex attributes, or NULL for DMOSI_MUTEX_ATTR_DEFAULT
+ * @return dmosi_mutex_t Created mutex handle, NULL on failure or if the requested protocol is not supported
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_mutex_t, _mutex_create_ex, (const dmosi_mutex_attr_t* attr) );
+
 /**
  * @brief Destroy a mutex
  *
@@ -107,8 +153,341 @@ DMOD_BUILTIN_API( dmosi, 1.0, int,           _mutex_lock,      (dmosi_mutex_t mu
  */
 DMOD_BUILTIN_API( dmosi, 1.0, int,           _mutex_unlock,    (dmosi_mutex_t mutex) );
 
+/**
+ * @brief Size in bytes of the control block passed to dmosi_mutex_create_static
+ *
+ * Upper bound on the size of any backend's mutex control block. Backends
+ * check their own control block against it at build time. It can be
+ * overridden before including dmosi.h, but then must be the same for the
+ * backend and every module in the image.
+ */
+#ifndef DMOSI_MUTEX_STORAGE_SIZE
+#   define DMOSI_MUTEX_STORAGE_SIZE     (24 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created mutex
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_MUTEX_STORAGE_SIZE) dmosi_mutex_storage_t;
+
+/**
+ * @brief Create a mutex in caller-provided storage
+ *
+ * Same as dmosi_mutex_create, but the control block lives in @p storage
+ * instead of being allocated from the heap, so mutexes can be placed in
+ * static arrays at link time. The mutex is destroyed with dmosi_mutex_destroy
+ * as usual, which releases it without freeing @p storage; @p storage must
+ * stay valid until then.
+ *
+ * @param recursive Whether the mutex should be recursive
+ * @param storage Control block storage
+ * @return dmosi_mutex_t Created mutex handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_mutex_t, _mutex_create_static, (bool recursive, dmosi_mutex_storage_t* storage) );
+
+/**
+ * @brief Print the mutex contention report
+ *
+ * Only available when dmosi is built with DMOSI_ENABLE_MUTEX_PROFILING. Every
+ * lock and unlock is then accounted per (mutex, module of the locking thread)
+ * pair: number of locks, how many of them found the mutex held by another
+ * thread, cumulative and longest wait, and longest hold time (in ticks of
+ * dmosi_get_tick_count). The @p top_n pairs with the most cumulative wait
+ * are written to the log (DMOD_STDLOG).
+ *
+ * @param top_n Maximum number of entries to report (0 = all)
+ * @return int Number of entries reported, -ENOSYS if profiling is not enabled
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _mutex_profile_dump, (size_t top_n) );
+
 /** @} */ // end of DMOSI_MUTEX_API
 
+//==============================================================================
+//                              Reader-Writer Lock API
+//==============================================================================
+/**
+ * @defgroup DMOSI_RWLOCK_API Reader-Writer Lock API
+ * @brief API for reader-writer lock operations in DMOD OSI
+ *
+ * A reader-writer lock lets any number of readers hold it at the same time,
+ * while a writer holds it exclusively. Meant for read-mostly shared state,
+ * where a plain mutex would needlessly serialize readers.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for reader-writer lock
+ *
+ * @note The actual implementation of the lock is hidden
+ * from the user and is specific to the underlying OS.
+ */
+typedef struct dmosi_rwlock* dmosi_rwlock_t;
+
+/**
+ * @brief Create a reader-writer lock
+ *
+ * @return dmosi_rwlock_t Created lock handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_rwlock_t, _rwlock_create,       (void) );
+
+/**
+ * @brief Destroy a reader-writer lock
+ *
+ * @param rwlock Lock handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,           _rwlock_destroy,      (dmosi_rwlock_t rwlock) );
+
+/**
+ * @brief Acquire a reader-writer lock for reading (shared)
+ *
+ * @param rwlock Lock handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _rwlock_read_lock,    (dmosi_rwlock_t rwlock, int32_t timeout_ms) );
+
+/**
+ * @brief Release a reader-writer lock previously acquired for reading
+ *
+ * @param rwlock Lock handle
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _rwlock_read_unlock,  (dmosi_rwlock_t rwlock) );
+
+/**
+ * @brief Acquire a reader-writer lock for writing (exclusive)
+ *
+ * @param rwlock Lock handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _rwlock_write_lock,   (dmosi_rwlock_t rwlock, int32_t timeout_ms) );
+
+/**
+ * @brief Release a reader-writer lock previously acquired for writing
+ *
+ * @param rwlock Lock handle
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _rwlock_write_unlock, (dmosi_rwlock_t rwlock) );
+
+/** @} */ // end of DMOSI_RWLOCK_API
+
+//==============================================================================
+//                              Condition Variable API
+//==============================================================================
+/**
+ * @defgroup DMOSI_COND_API Condition Variable API
+ * @brief Condition variables paired with dmosi_mutex_t
+ *
+ * Lets a thread wait for a predicate on mutex-protected state without
+ * polling: dmosi_cond_wait releases the mutex and goes to sleep as one
+ * atomic step, and re-acquires the mutex before returning. As with any
+ * condition variable, wakeups may be spurious, so the predicate must be
+ * re-checked in a loop.
+ *
+ * dmosi.c provides a generic implementation built on dmosi_mutex_t and
+ * dmosi_semaphore_t for backends without a native condition variable. A
+ * backend that overrides any of these functions must override all of them.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for condition variable
+ *
+ * @note The actual implementation of the condition variable is hidden
+ * from the user and is specific to the underlying OS.
+ */
+typedef struct dmosi_cond* dmosi_cond_t;
+
+/**
+ * @brief Create a condition variable
+ *
+ * @return dmosi_cond_t Created condition variable handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_cond_t, _cond_create,    (void) );
+
+/**
+ * @brief Destroy a condition variable
+ *
+ * No thread may be waiting on it.
+ *
+ * @param cond Condition variable handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,         _cond_destroy,   (dmosi_cond_t cond) );
+
+/**
+ * @brief Wait on a condition variable
+ *
+ * Atomically releases @p mutex (which must be locked once by the caller)
+ * and waits until the condition variable is signalled or the timeout
+ * expires. @p mutex is locked again before returning, whatever the result.
+ *
+ * @param cond Condition variable handle
+ * @param mutex Mutex protecting the predicate
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 when woken, -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,          _cond_wait,      (dmosi_cond_t cond, dmosi_mutex_t mutex, int32_t timeout_ms) );
+
+/**
+ * @brief Wake one thread waiting on a condition variable
+ *
+ * Does nothing if no thread is waiting. May be called with or without the
+ * paired mutex held.
+ *
+ * @param cond Condition variable handle
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,          _cond_signal,    (dmosi_cond_t cond) );
+
+/**
+ * @brief Wake every thread waiting on a condition variable
+ *
+ * @param cond Condition variable handle
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,          _cond_broadcast, (dmosi_cond_t cond) );
+
+/** @} */ // end of DMOSI_COND_API
+
+//==============================================================================
+//                              Barrier, Latch and Once API
+//==============================================================================
+/**
+ * @defgroup DMOSI_BARRIER_API Barrier, Latch and Once API
+ * @brief Phase synchronization and one-time initialization
+ *
+ * - a barrier makes a fixed group of threads wait for each other at the end
+ *   of each phase, and can be reused for any number of phases;
+ * - a latch is a one-shot countdown that threads can wait to reach zero;
+ * - dmosi_once runs an initialization function exactly once, however many
+ *   threads race to call it.
+ *
+ * dmosi.c implements all of them generically on top of the mutex, semaphore
+ * and address wait APIs. A backend that overrides one of the barrier or
+ * latch functions must override that whole object's family.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for barrier
+ */
+typedef struct dmosi_barrier* dmosi_barrier_t;
+
+/**
+ * @brief Value returned by dmosi_barrier_wait to the one thread that completed a phase
+ */
+#define DMOSI_BARRIER_SERIAL_THREAD     1
+
+/**
+ * @brief Create a barrier
+ *
+ * @param count Number of threads that take part in each phase (must not be 0)
+ * @return dmosi_barrier_t Created barrier handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_barrier_t, _barrier_create,  (uint32_t count) );
+
+/**
+ * @brief Destroy a barrier
+ *
+ * No thread may be waiting on it.
+ *
+ * @param barrier Barrier handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,            _barrier_destroy, (dmosi_barrier_t barrier) );
+
+/**
+ * @brief Wait at a barrier until every participant has arrived
+ *
+ * The last thread to arrive releases all the others at once and returns
+ * without blocking; the barrier is then immediately ready for the next phase.
+ * A call that fails is not counted as an arrival, so the phase still waits
+ * for the calling thread and the call may simply be retried.
+ *
+ * @param barrier Barrier handle
+ * @return int DMOSI_BARRIER_SERIAL_THREAD for the thread that completed the
+ *         phase, 0 for the others, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,             _barrier_wait,    (dmosi_barrier_t barrier) );
+
+/**
+ * @brief Opaque type for latch
+ */
+typedef struct dmosi_latch* dmosi_latch_t;
+
+/**
+ * @brief Create a latch
+ *
+ * @param count Initial count; waiters are released when it reaches zero
+ * @return dmosi_latch_t Created latch handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_latch_t, _latch_create,     (uint32_t count) );
+
+/**
+ * @brief Destroy a latch
+ *
+ * No thread may be waiting on it.
+ *
+ * @param latch Latch handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,          _latch_destroy,    (dmosi_latch_t latch) );
+
+/**
+ * @brief Decrement the count of a latch
+ *
+ * The count saturates at zero; reaching zero releases every waiter and
+ * leaves the latch open for good.
+ *
+ * @param latch Latch handle
+ * @param count Amount to subtract from the count
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _latch_count_down, (dmosi_latch_t latch, uint32_t count) );
+
+/**
+ * @brief Wait for the count of a latch to reach zero
+ *
+ * @param latch Latch handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once the count is zero, -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _latch_wait,       (dmosi_latch_t latch, int32_t timeout_ms) );
+
+/**
+ * @brief One-time initialization flag
+ *
+ * Must be initialized with DMOSI_ONCE_INIT, typically as a static variable.
+ */
+typedef struct {
+    uint32_t state;     //!< Internal state - do not access directly
+} dmosi_once_t;
+
+/**
+ * @brief Static initializer for dmosi_once_t
+ */
+#define DMOSI_ONCE_INIT     { 0 }
+
+/**
+ * @brief One-time initialization function type
+ */
+typedef void (*dmosi_once_fn_t)(void);
+
+/**
+ * @brief Run a function exactly once
+ *
+ * The first caller runs @p fn; callers racing with it wait until it has
+ * returned, so on return from dmosi_once the initialization is always
+ * complete and visible. Later calls only cost an atomic load.
+ *
+ * @param once One-time initialization flag
+ * @param fn Function to run
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int, _once, (dmosi_once_t* once, dmosi_once_fn_t fn) );
+
+/** @} */ // end of DMOSI_BARRIER_API
+
 //==============================================================================
 //                              Forward declarations
 //==============================================================================
@@ -224,6 +603,33 @@ DMOD_BUILTIN_API( dmosi, 1.0, dmosi_process_t, _process_current,   (void) );
  */
 DMOD_BUILTIN_API( dmosi, 1.0, int,            _process_set_current, (dmosi_process_t process) );
 
+/**
+ * @brief Get current process through the calling thread's cache
+ *
+ * Same result as dmosi_process_current. When dmosi is built with
+ * DMOSI_ENABLE_PROCESS_CACHE, the handle is kept in a reserved thread-local
+ * storage slot after the first lookup, so hot paths such as the DMOD stdio
+ * and logging bridges read it from the thread control block instead of
+ * asking the backend on every call. Without it, or when the backend provides
+ * no TLS slots, this just calls dmosi_process_current.
+ *
+ * @return dmosi_process_t Current process handle, NULL if none
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_process_t, _process_current_cached, (void) );
+
+/**
+ * @brief Invalidate the cached current process of a thread
+ *
+ * DMOSI_ENABLE_PROCESS_CACHE may only be turned on with a backend that calls
+ * this from dmosi_process_set_current (and wherever else it moves a thread
+ * to another process), so that the next dmosi_process_current_cached looks
+ * the process up again. dmosi calls it itself after its own calls to
+ * dmosi_process_set_current. New threads start with an empty cache.
+ *
+ * @param thread Thread whose cache to clear (NULL for the calling thread)
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,           _process_invalidate_cached, (dmosi_thread_t thread) );
+
 /**
  * @brief Get process state
  *
@@ -414,9 +820,9 @@ DMOD_BUILTIN_API( dmosi, 1.0, const char*,     _process_get_stream_path, (dmosi_
  * @brief Lock a process stream slot for exclusive access
  *
  * Fails if the slot is already locked. Implementations must use an
- * interrupt-safe primitive (e.g. an atomic compare-and-swap or a critical
- * section), not a mutex, since this function must be callable from
- * interrupt context.
+ * interrupt-safe primitive (e.g. an atomic compare-and-swap or
+ * dmosi_critical_enter), not a mutex, since this function must be callable
+ * from interrupt context.
  *
  * @param process Process handle
  * @param index Stream slot to lock (see dmosi_stream_index_t for well-known slots)
@@ -519,6 +925,45 @@ DMOD_BUILTIN_API( dmosi, 1.0, dmosi_process_exit_callback_handle_t, _process_reg
  */
 DMOD_BUILTIN_API( dmosi, 1.0, int,            _process_unregister_exit_callback, (dmosi_process_t process, dmosi_process_exit_callback_handle_t handle) );
 
+/**
+ * @brief Start parked workers for Dmod_Spawn and Dmod_RunDetached
+ *
+ * Only available when dmosi is built with DMOSI_ENABLE_SPAWN_POOL (and
+ * implements the DMOD process API). Starts @p count worker threads, each
+ * parked in a process of its own, with a stack fitting modules that need
+ * @p stack_size bytes (as returned by Dmod_GetStackSize, 0 = default). A
+ * spawn whose stack falls into the same size class and whose priority equals
+ * @p priority is then handed to an idle worker, which adopts the new process
+ * with dmosi_process_set_current, instead of creating a thread. Workers park
+ * again when the module returns; spawns finding none idle create a thread as
+ * usual.
+ *
+ * The destructors of the module's TLS values run before it is unloaded.
+ * A worker whose priority the module changed is not parked again but ends,
+ * and is reaped by dmosi_spawn_pool_trim. Thread exit callbacks a module
+ * registers on its own thread are not removed: a module that may run on a
+ * pooled worker must unregister them before it returns.
+ *
+ * @param stack_size Module stack size the workers are sized for
+ * @param priority Priority of the workers (0 = default)
+ * @param count Number of workers to start
+ * @return int Number of workers started, negative error code on failure
+ *         (-ENOSYS if the spawn pool is not enabled, or if the backend's
+ *         dmosi_process_set_current fails - spawns then keep creating threads)
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _spawn_pool_prewarm, (size_t stack_size, int priority, size_t count) );
+
+/**
+ * @brief Stop the idle workers of the spawn pool
+ *
+ * Workers busy running a module are not affected and park again when done.
+ * Also joins and frees workers that ended because a module changed their
+ * priority (these are not counted).
+ *
+ * @return int Number of workers stopped, -ENOSYS if the spawn pool is not enabled
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _spawn_pool_trim,    (void) );
+
 /** @} */ // end of DMOSI_PROCESS_API
 
 //==============================================================================
@@ -578,6 +1023,20 @@ typedef struct {
  */
 #define DMOSI_THREAD_STACK_OVERHEAD 512
 
+/**
+ * @brief Size in bytes of the control block passed to dmosi_thread_create_static
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE for how this value may be overridden.
+ */
+#ifndef DMOSI_THREAD_STORAGE_SIZE
+#   define DMOSI_THREAD_STORAGE_SIZE    (96 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created thread
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_THREAD_STORAGE_SIZE) dmosi_thread_storage_t;
+
 /**
  * @brief Create a thread
  *
@@ -591,6 +1050,25 @@ typedef struct {
  */
 DMOD_BUILTIN_API( dmosi, 1.0, dmosi_thread_t, _thread_create,    (dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process) );
 
+/**
+ * @brief Create a thread in caller-provided storage
+ *
+ * Same as dmosi_thread_create, but neither the control block nor the stack
+ * is allocated from the heap. See dmosi_mutex_create_static for the
+ * lifetime rules of the storage.
+ *
+ * @param entry Entry function for the thread
+ * @param arg Argument to pass to the entry function
+ * @param priority Thread priority
+ * @param stack_size Size of @p stack in bytes
+ * @param name              Name of the thread (cannot be NULL)
+ * @param process           Process to associate the thread with (NULL = current process)
+ * @param storage Control block storage
+ * @param stack Stack memory of @p stack_size bytes (aligned to at least 8 bytes)
+ * @return dmosi_thread_t Created thread handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_thread_t, _thread_create_static, (dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process, dmosi_thread_storage_t* storage, void* stack) );
+
 /**
  * @brief Destroy a thread
  *
@@ -636,6 +1114,43 @@ DMOD_BUILTIN_API( dmosi, 1.0, dmosi_thread_t, _thread_current,   (void) );
  */
 DMOD_BUILTIN_API( dmosi, 1.0, void,          _thread_sleep,     (uint32_t ms) );
 
+/**
+ * @brief Sleep until an absolute tick count, for drift-free periodic loops
+ *
+ * Sleeps until dmosi_get_tick_count reaches @p next_wake_tick and then
+ * advances it by @p period, so a loop calling this once per iteration keeps
+ * its period regardless of how long each iteration takes:
+ *
+ * @code
+ * uint32_t next_wake = dmosi_get_tick_count();
+ * for (;;) {
+ *     dmosi_thread_sleep_until(&next_wake, 1);
+ *     control_step();
+ * }
+ * @endcode
+ *
+ * If the deadline has already passed the call returns at once, still
+ * advancing @p next_wake_tick by one period. Backends map this to an absolute
+ * wait (e.g. vTaskDelayUntil, or clock_nanosleep with TIMER_ABSTIME on the
+ * POSIX host).
+ *
+ * @param next_wake_tick Tick count to wake at, advanced by @p period on return
+ * @param period Period in ticks
+ * @return int 0 on success, -ETIMEDOUT if the deadline had already passed,
+ *         -EINVAL if @p next_wake_tick is NULL
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _thread_sleep_until, (uint32_t* next_wake_tick, uint32_t period) );
+
+/**
+ * @brief Sleep for a specified time in microseconds
+ *
+ * Backends with a high-resolution timer sleep for the requested time (e.g.
+ * nanosleep on the POSIX host); others round up to whole milliseconds.
+ *
+ * @param us Time to sleep in microseconds
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,          _thread_sleep_us,  (uint32_t us) );
+
 /**
  * @brief Get thread name
  *
@@ -713,26 +1228,97 @@ DMOD_BUILTIN_API( dmosi, 1.0, size_t, _thread_get_by_process, (dmosi_process_t p
 DMOD_BUILTIN_API( dmosi, 1.0, int, _thread_get_info, (dmosi_thread_t thread, dmosi_thread_info_t* info) );
 
 /**
- * @brief Thread exit callback function type
- *
- * Invoked when the thread it was registered on terminates.
- *
- * @param thread Thread handle that terminated
- * @param arg User-provided argument passed at registration time
+ * @brief Set of CPU cores, one bit per core (bit 0 = core 0)
  */
-typedef void (*dmosi_thread_exit_callback_t)(dmosi_thread_t thread, void* arg);
+typedef uint64_t dmosi_cpu_mask_t;
 
 /**
- * @brief Opaque handle for a registered thread exit callback
- *
- * Returned by dmosi_thread_register_exit_callback and used to identify the
- * registration when calling dmosi_thread_unregister_exit_callback.
+ * @brief Number of cores a dmosi_cpu_mask_t can name
  */
-typedef struct dmosi_thread_exit_callback* dmosi_thread_exit_callback_handle_t;
+#define DMOSI_CPU_MASK_BITS     64
 
 /**
- * @brief Register a callback to be invoked when a thread terminates
- *
+ * @brief Mask of a single core (@p core must be below DMOSI_CPU_MASK_BITS)
+ */
+#define DMOSI_CPU_MASK(core)    ((dmosi_cpu_mask_t)1u << (core))
+
+/**
+ * @brief Mask of every core
+ */
+#define DMOSI_CPU_MASK_ALL      (~(dmosi_cpu_mask_t)0u)
+
+/**
+ * @brief Restrict the cores a thread may run on
+ *
+ * Bits of cores that don't exist are ignored. If the thread is running on a
+ * core outside the new mask, it is migrated before this returns (when it is
+ * the calling thread) or when it is next scheduled.
+ *
+ * @param thread Thread handle (if NULL, sets the affinity of the current thread)
+ * @param mask Cores the thread may run on; must include at least one existing core
+ * @return int 0 on success, -EINVAL if @p mask includes no existing core,
+ *         other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int, _thread_set_affinity, (dmosi_thread_t thread, dmosi_cpu_mask_t mask) );
+
+/**
+ * @brief Get the cores a thread may run on
+ *
+ * @param thread Thread handle (if NULL, gets the affinity of the current thread)
+ * @param mask Filled with the cores the thread may run on
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int, _thread_get_affinity, (dmosi_thread_t thread, dmosi_cpu_mask_t* mask) );
+
+/**
+ * @brief Get the number of CPU cores available to the scheduler
+ *
+ * @return uint32_t Number of cores, at least 1
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t, _get_core_count, (void) );
+
+/**
+ * @brief Get the core the calling thread is running on
+ *
+ * The result may be stale as soon as it is returned unless the thread is
+ * pinned to a single core.
+ *
+ * @return uint32_t Index of the current core (0 on single-core targets)
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t, _get_current_core, (void) );
+
+/**
+ * @brief Get the core a thread last ran on
+ *
+ * Like dmosi_get_current_core, the result may be stale as soon as it is
+ * returned unless the thread is pinned to a single core.
+ *
+ * @param thread Thread handle (if NULL, gets the last core of the current thread)
+ * @return uint32_t Index of the core (0 on single-core targets)
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t, _thread_get_last_core, (dmosi_thread_t thread) );
+
+/**
+ * @brief Thread exit callback function type
+ *
+ * Invoked when the thread it was registered on terminates.
+ *
+ * @param thread Thread handle that terminated
+ * @param arg User-provided argument passed at registration time
+ */
+typedef void (*dmosi_thread_exit_callback_t)(dmosi_thread_t thread, void* arg);
+
+/**
+ * @brief Opaque handle for a registered thread exit callback
+ *
+ * Returned by dmosi_thread_register_exit_callback and used to identify the
+ * registration when calling dmosi_thread_unregister_exit_callback.
+ */
+typedef struct dmosi_thread_exit_callback* dmosi_thread_exit_callback_handle_t;
+
+/**
+ * @brief Register a callback to be invoked when a thread terminates
+ *
  * Multiple callbacks may be registered on the same thread; each registration
  * returns its own handle and all of them are invoked when the thread
  * terminates.
@@ -755,6 +1341,121 @@ DMOD_BUILTIN_API( dmosi, 1.0, int,            _thread_unregister_exit_callback,
 
 /** @} */ // end of DMOSI_THREAD_API
 
+//==============================================================================
+//                              Thread-Local Storage API
+//==============================================================================
+/**
+ * @defgroup DMOSI_TLS_API Thread-Local Storage API
+ * @brief Per-thread values looked up by key
+ *
+ * Every thread control block holds DMOSI_TLS_SLOT_COUNT pointer-sized slots,
+ * so reading or writing a thread-local value is an index into the current
+ * thread's slots rather than a search in a table of threads. The first
+ * DMOSI_TLS_RESERVED_SLOTS slots are used by dmosi itself; the others are
+ * handed out by dmosi_tls_key_create.
+ *
+ * The backend only provides the slots (dmosi_thread_get_tls_slots, with
+ * every slot NULL when a thread is created); keys and destructors are
+ * managed generically in dmosi.c.
+ * @{
+ */
+
+/**
+ * @brief Number of thread-local storage slots in each thread control block
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE for how this value may be overridden.
+ * Must not exceed 32.
+ */
+#ifndef DMOSI_TLS_SLOT_COUNT
+#   define DMOSI_TLS_SLOT_COUNT     8
+#endif
+
+/**
+ * @brief Number of slots reserved for dmosi itself, at the start of the slots
+ */
+#define DMOSI_TLS_RESERVED_SLOTS    2
+
+/**
+ * @brief Thread-local storage key
+ *
+ * Never 0. A deleted key stays invalid even after its slot is handed out
+ * again, so it can't read or write the values of the key that reuses it.
+ */
+typedef uint32_t dmosi_tls_key_t;
+
+/**
+ * @brief Destructor of thread-local values
+ *
+ * Called on thread exit for each key with a non-NULL value in the exiting
+ * thread.
+ *
+ * @param value Value the thread held for the key
+ */
+typedef void (*dmosi_tls_destructor_t)(void* value);
+
+/**
+ * @brief Get the thread-local storage slots of a thread
+ *
+ * Implemented by the backend, which keeps DMOSI_TLS_SLOT_COUNT slots in
+ * each thread control block, all NULL when the thread is created. Meant for
+ * the dmosi_tls_* functions; modules should use those instead.
+ *
+ * @param thread Thread handle (if NULL, returns the slots of the current thread)
+ * @return void** Array of DMOSI_TLS_SLOT_COUNT slots, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void**, _thread_get_tls_slots, (dmosi_thread_t thread) );
+
+/**
+ * @brief Create a thread-local storage key
+ *
+ * The new key holds NULL in every thread.
+ *
+ * The destructor must outlive the key's values: it is called whenever a
+ * thread holding a value exits, so a module must not pass a destructor of
+ * its own while threads it doesn't control may still hold values when it is
+ * unloaded - it deletes the key first. The thread of a module started with
+ * Dmod_Spawn or Dmod_RunDetached runs its destructors when the module
+ * returns, before the module is unloaded.
+ *
+ * @param key Filled with the new key
+ * @param destructor Called on thread exit with the thread's non-NULL value (may be NULL)
+ * @return int 0 on success, -EAGAIN if every slot is in use, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,   _tls_key_create, (dmosi_tls_key_t* key, dmosi_tls_destructor_t destructor) );
+
+/**
+ * @brief Delete a thread-local storage key
+ *
+ * The values threads hold for the key are dropped without calling the
+ * destructor, and the key's slot may be handed out again by
+ * dmosi_tls_key_create; the new key reads NULL in every thread. The deleted
+ * key is rejected by dmosi_tls_set and reads NULL from then on.
+ *
+ * @param key Key to delete
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,   _tls_key_delete, (dmosi_tls_key_t key) );
+
+/**
+ * @brief Set the calling thread's value of a key
+ *
+ * @param key Key created with dmosi_tls_key_create
+ * @param value New value
+ * @return int 0 on success, -EINVAL if @p key was deleted or never created,
+ *         other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,   _tls_set,        (dmosi_tls_key_t key, void* value) );
+
+/**
+ * @brief Get the calling thread's value of a key
+ *
+ * @param key Key created with dmosi_tls_key_create
+ * @return void* Value of the key, NULL if never set or on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void*, _tls_get,        (dmosi_tls_key_t key) );
+
+/** @} */ // end of DMOSI_TLS_API
+
 //==============================================================================
 //                              Semaphore API
 //==============================================================================
@@ -784,6 +1485,33 @@ typedef struct dmosi_semaphore* dmosi_semaphore_t;
  */
 DMOD_BUILTIN_API( dmosi, 1.0, dmosi_semaphore_t, _semaphore_create,  (uint32_t initial_count, uint32_t max_count) );
 
+/**
+ * @brief Size in bytes of the control block passed to dmosi_semaphore_create_static
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE for how this value may be overridden.
+ */
+#ifndef DMOSI_SEMAPHORE_STORAGE_SIZE
+#   define DMOSI_SEMAPHORE_STORAGE_SIZE (24 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created semaphore
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_SEMAPHORE_STORAGE_SIZE) dmosi_semaphore_storage_t;
+
+/**
+ * @brief Create a semaphore in caller-provided storage
+ *
+ * Same as dmosi_semaphore_create, but the control block lives in @p storage.
+ * See dmosi_mutex_create_static for the lifetime rules of the storage.
+ *
+ * @param initial_count Initial count for the semaphore
+ * @param max_count Maximum count for the semaphore
+ * @param storage Control block storage
+ * @return dmosi_semaphore_t Created semaphore handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_semaphore_t, _semaphore_create_static, (uint32_t initial_count, uint32_t max_count, dmosi_semaphore_storage_t* storage) );
+
 /**
  * @brief Destroy a semaphore
  *
@@ -810,65 +1538,691 @@ DMOD_BUILTIN_API( dmosi, 2.0, int,               _semaphore_wait,    (dmosi_sema
  */
 DMOD_BUILTIN_API( dmosi, 2.0, int,               _semaphore_post,    (dmosi_semaphore_t semaphore, uint32_t count) );
 
+/**
+ * @brief Post to a semaphore from interrupt context
+ *
+ * Never blocks and never switches context itself. If the post unblocks a
+ * thread with a higher priority than the interrupted one, @p higher_priority_woken
+ * is set to true (it is never set to false, so one flag can be shared by
+ * several _from_isr calls); pass it to dmosi_yield_from_isr at the end of
+ * the ISR.
+ *
+ * @param semaphore Semaphore handle
+ * @param count Number of semaphore units to release
+ * @param higher_priority_woken Set to true if a context switch should be requested on ISR exit (can be NULL)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,               _semaphore_post_from_isr, (dmosi_semaphore_t semaphore, uint32_t count, bool* higher_priority_woken) );
+
 /** @} */ // end of DMOSI_SEMAPHORE_API
 
-//==============================================================================
-//                              Queue API
-//==============================================================================
+//==============================================================================
+//                              Address Wait API
+//==============================================================================
+/**
+ * @defgroup DMOSI_ADDRESS_WAIT_API Address Wait API
+ * @brief Futex-style wait/wake on a 32-bit word
+ *
+ * Building blocks for user-level synchronization primitives (locks,
+ * latches, flags) that handle the uncontended case purely with atomic
+ * operations on a word of their own, and only call into the kernel when a
+ * thread actually has to sleep or be woken. The kernel keeps no state
+ * between calls beyond the list of threads sleeping on each address.
+ * @{
+ */
+
+/**
+ * @brief Wake count meaning "every waiter" for dmosi_wake_address
+ */
+#define DMOSI_WAKE_ALL      UINT32_MAX
+
+/**
+ * @brief Sleep while a 32-bit word holds an expected value
+ *
+ * Atomically checks that *@p address still equals @p expected and, if so,
+ * puts the calling thread to sleep until dmosi_wake_address is called for
+ * the same address, or the timeout expires. The check and the sleep are
+ * atomic with respect to dmosi_wake_address, so a wake issued after the
+ * value was changed is never lost. Wakeups may be spurious: callers must
+ * re-check the word after this returns.
+ *
+ * @param address Address of the word to wait on
+ * @param expected Value the word is expected to hold
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 when woken, -EAGAIN if *@p address did not equal @p expected,
+ *         -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int, _wait_on_address, (const volatile uint32_t* address, uint32_t expected, int32_t timeout_ms) );
+
+/**
+ * @brief Wake threads sleeping in dmosi_wait_on_address on an address
+ *
+ * @param address Address of the word threads are waiting on
+ * @param count Maximum number of threads to wake (DMOSI_WAKE_ALL = every waiter)
+ * @return int Number of threads woken, or negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int, _wake_address,    (const volatile uint32_t* address, uint32_t count) );
+
+/** @} */ // end of DMOSI_ADDRESS_WAIT_API
+
+//==============================================================================
+//                              Event Group API
+//==============================================================================
+/**
+ * @defgroup DMOSI_EVENT_GROUP_API Event Group API
+ * @brief 32-bit event flag groups
+ *
+ * A group of 32 event bits that threads can wait on in combination - any of
+ * a set of bits, or all of them - with a single object and a single wakeup.
+ * @{
+ */
+
+/**
+ * @brief Event group handle type
+ */
+typedef struct dmosi_event_group* dmosi_event_group_t;
+
+/**
+ * @brief Flags for dmosi_event_group_wait
+ */
+typedef enum {
+    DMOSI_EVENT_WAIT_ANY    = 0,        /**< Wake when any of the requested bits is set */
+    DMOSI_EVENT_WAIT_ALL    = 1u << 0,  /**< Wake only when all of the requested bits are set */
+    DMOSI_EVENT_AUTO_CLEAR  = 1u << 1,  /**< Clear the requested bits atomically on wakeup */
+} dmosi_event_group_flags_t;
+
+/**
+ * @brief Create an event group with all bits cleared
+ *
+ * @return dmosi_event_group_t Created event group handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_event_group_t, _event_group_create,   (void) );
+
+/**
+ * @brief Size in bytes of the control block passed to dmosi_event_group_create_static
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE.
+ */
+#ifndef DMOSI_EVENT_GROUP_STORAGE_SIZE
+#   define DMOSI_EVENT_GROUP_STORAGE_SIZE   (24 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created event group
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_EVENT_GROUP_STORAGE_SIZE) dmosi_event_group_storage_t;
+
+/**
+ * @brief Create an event group in caller-provided storage
+ *
+ * See dmosi_mutex_create_static for the lifetime rules of the storage.
+ *
+ * @param storage Control block storage
+ * @return dmosi_event_group_t Created event group handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_event_group_t, _event_group_create_static, (dmosi_event_group_storage_t* storage) );
+
+/**
+ * @brief Destroy an event group
+ *
+ * @param group Event group handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,     _event_group_destroy,  (dmosi_event_group_t group) );
+
+/**
+ * @brief Set bits in an event group
+ *
+ * Wakes every waiter whose condition is satisfied by the new bits.
+ *
+ * @param group Event group handle
+ * @param bits Bits to set
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,      _event_group_set,      (dmosi_event_group_t group, uint32_t bits) );
+
+/**
+ * @brief Set bits in an event group from an interrupt handler
+ *
+ * ISR-safe variant of dmosi_event_group_set. See dmosi_queue_send_from_isr
+ * for the meaning of @p higher_priority_woken.
+ *
+ * @param group Event group handle
+ * @param bits Bits to set
+ * @param higher_priority_woken Set to true if a higher-priority thread was woken (may be NULL)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,      _event_group_set_from_isr, (dmosi_event_group_t group, uint32_t bits, bool* higher_priority_woken) );
+
+/**
+ * @brief Clear bits in an event group
+ *
+ * @param group Event group handle
+ * @param bits Bits to clear
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,      _event_group_clear,    (dmosi_event_group_t group, uint32_t bits) );
+
+/**
+ * @brief Get the current bits of an event group
+ *
+ * @param group Event group handle
+ * @return uint32_t Current bits, 0 if the group is invalid
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t, _event_group_get,      (dmosi_event_group_t group) );
+
+/**
+ * @brief Wait for bits of an event group
+ *
+ * Returns immediately if the condition already holds. With
+ * DMOSI_EVENT_AUTO_CLEAR the requested bits are cleared atomically with the
+ * wakeup, so exactly one waiter consumes them per setting.
+ *
+ * @param group Event group handle
+ * @param bits Bits to wait for (must not be 0)
+ * @param flags Combination of dmosi_event_group_flags_t values
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @param bits_out Set to the group's bits when the condition was met (before
+ *                 any auto-clear), or to the current bits on timeout (may be NULL)
+ * @return int 0 when the condition was met, -ETIMEDOUT on timeout,
+ *         other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,      _event_group_wait,     (dmosi_event_group_t group, uint32_t bits, uint32_t flags, int32_t timeout_ms, uint32_t* bits_out) );
+
+/** @} */ // end of DMOSI_EVENT_GROUP_API
+
+//==============================================================================
+//                              Queue API
+//==============================================================================
+/**
+ * @defgroup DMOSI_QUEUE_API Queue API
+ * @brief API for queue operations in DMOD OSI
+ * This API provides functions to create, destroy, and use queues.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for queue
+ *
+ * This type represents a queue in the DMOD OSI system.
+ *
+ * @note The actual implementation of the queue is hidden
+ * from the user and is specific to the underlying OS.
+ */
+typedef struct dmosi_queue* dmosi_queue_t;
+
+/**
+ * @brief Create a queue
+ *
+ * @param item_size Size of each item in the queue
+ * @param queue_length Maximum number of items in the queue
+ * @return dmosi_queue_t Created queue handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_queue_t, _queue_create,  (size_t item_size, uint32_t queue_length) );
+
+/**
+ * @brief Queue creation flags
+ *
+ * Passed (OR-ed together) to dmosi_queue_create_ex.
+ */
+typedef enum {
+    DMOSI_QUEUE_DEFAULT   = 0,          /**< Same behavior as dmosi_queue_create */
+    DMOSI_QUEUE_OVERWRITE = (1u << 0),  /**< Sending never blocks: when the queue is full, the oldest item is replaced */
+} dmosi_queue_flags_t;
+
+/**
+ * @brief Create a queue with extra behavior flags
+ *
+ * With DMOSI_QUEUE_OVERWRITE, a queue of length 1 acts as a mailbox holding
+ * only the latest value: the sender overwrites it in one step, and receivers
+ * can read it with dmosi_queue_peek without taking it.
+ *
+ * @param item_size Size of each item in the queue
+ * @param queue_length Maximum number of items in the queue
+ * @param flags Combination of dmosi_queue_flags_t values
+ * @return dmosi_queue_t Created queue handle, NULL on failure or if a flag is not supported
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_queue_t, _queue_create_ex, (size_t item_size, uint32_t queue_length, uint32_t flags) );
+
+/**
+ * @brief Size in bytes of the control block passed to dmosi_queue_create_static
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE for how this value may be overridden.
+ */
+#ifndef DMOSI_QUEUE_STORAGE_SIZE
+#   define DMOSI_QUEUE_STORAGE_SIZE     (48 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created queue's control block
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_QUEUE_STORAGE_SIZE) dmosi_queue_storage_t;
+
+/**
+ * @brief Number of bytes of item buffer needed by dmosi_queue_create_static
+ *
+ * @param item_size Size of each item in the queue
+ * @param queue_length Maximum number of items in the queue
+ */
+#define DMOSI_QUEUE_BUFFER_SIZE(item_size, queue_length)   ((size_t)(item_size) * (size_t)(queue_length))
+
+/**
+ * @brief Create a queue in caller-provided storage
+ *
+ * Same as dmosi_queue_create, but neither the control block nor the item
+ * buffer is allocated from the heap. See dmosi_mutex_create_static for the
+ * lifetime rules of the storage.
+ *
+ * @param item_size Size of each item in the queue
+ * @param queue_length Maximum number of items in the queue
+ * @param storage Control block storage
+ * @param buffer Item buffer of DMOSI_QUEUE_BUFFER_SIZE(item_size, queue_length) bytes
+ * @return dmosi_queue_t Created queue handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_queue_t, _queue_create_static, (size_t item_size, uint32_t queue_length, dmosi_queue_storage_t* storage, void* buffer) );
+
+/**
+ * @brief Destroy a queue
+ *
+ * @param queue Queue handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,          _queue_destroy, (dmosi_queue_t queue) );
+
+/**
+ * @brief Send data to a queue
+ *
+ * @param queue Queue handle
+ * @param item Pointer to the item to send
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_send,    (dmosi_queue_t queue, const void* item, int32_t timeout_ms) );
+
+/**
+ * @brief Receive data from a queue
+ *
+ * @param queue Queue handle
+ * @param item Pointer to buffer to receive the item
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_receive, (dmosi_queue_t queue, void* item, int32_t timeout_ms) );
+
+/**
+ * @brief Send data to a queue from interrupt context
+ *
+ * Never blocks: fails straight away if the queue is full. See
+ * dmosi_semaphore_post_from_isr for the meaning of @p higher_priority_woken.
+ *
+ * @param queue Queue handle
+ * @param item Pointer to the item to send
+ * @param higher_priority_woken Set to true if a context switch should be requested on ISR exit (can be NULL)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_send_from_isr,    (dmosi_queue_t queue, const void* item, bool* higher_priority_woken) );
+
+/**
+ * @brief Receive data from a queue from interrupt context
+ *
+ * Never blocks: fails straight away if the queue is empty. See
+ * dmosi_semaphore_post_from_isr for the meaning of @p higher_priority_woken.
+ *
+ * @param queue Queue handle
+ * @param item Pointer to buffer to receive the item
+ * @param higher_priority_woken Set to true if a context switch should be requested on ISR exit (can be NULL)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_receive_from_isr, (dmosi_queue_t queue, void* item, bool* higher_priority_woken) );
+
+/**
+ * @brief Copy the oldest item out of a queue without removing it
+ *
+ * @param queue Queue handle
+ * @param item Pointer to buffer to receive a copy of the item
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_peek,    (dmosi_queue_t queue, void* item, int32_t timeout_ms) );
+
+/**
+ * @brief Get the size of a single queue item
+ *
+ * @param queue Queue handle
+ * @return size_t Item size in bytes the queue was created with, 0 on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, size_t,        _queue_get_item_size, (dmosi_queue_t queue) );
+
+/**
+ * @brief Queue runtime statistics
+ *
+ * Counters accumulate from the moment the queue is created. Blocked times
+ * only include time a caller actually spent waiting (not calls that
+ * succeeded straight away).
+ */
+typedef struct {
+    size_t   item_size;             /**< Size of each item in bytes */
+    uint32_t length;                /**< Maximum number of items (capacity) */
+    uint32_t depth;                 /**< Current number of items */
+    uint32_t peak_depth;            /**< Highest number of items ever held at once (high watermark) */
+    uint64_t total_sends;           /**< Number of items successfully sent */
+    uint64_t total_receives;        /**< Number of items successfully received */
+    uint32_t send_timeouts;         /**< Number of sends that failed because the queue stayed full */
+    uint32_t receive_timeouts;      /**< Number of receives that failed because the queue stayed empty */
+    uint64_t send_blocked_ms;       /**< Cumulative time senders spent blocked, in milliseconds */
+    uint32_t send_max_blocked_ms;   /**< Longest single time a sender spent blocked, in milliseconds */
+    uint64_t receive_blocked_ms;    /**< Cumulative time receivers spent blocked, in milliseconds */
+    uint32_t receive_max_blocked_ms;/**< Longest single time a receiver spent blocked, in milliseconds */
+} dmosi_queue_stats_t;
+
+/**
+ * @brief Get runtime statistics of a queue
+ *
+ * @param queue Queue handle
+ * @param stats Pointer to a dmosi_queue_stats_t structure to fill
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_get_stats, (dmosi_queue_t queue, dmosi_queue_stats_t* stats) );
+
+/**
+ * @brief Get an array of all queues
+ *
+ * Fills the provided array with handles of all existing queues.
+ * If @p queues is NULL, the function returns the total number of queues
+ * without writing anything, which is useful for determining the array size
+ * needed before allocation.
+ *
+ * @param queues Pointer to array to fill with queue handles, or NULL to query count only
+ * @param max_count Maximum number of handles to write into @p queues (ignored when @p queues is NULL)
+ * @return size_t Number of queues (when @p queues is NULL) or number of handles written
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, size_t,        _queue_get_all,   (dmosi_queue_t* queues, size_t max_count) );
+
+/**
+ * @brief Send several items to a queue in a single call
+ *
+ * @p items points to @p count items laid out contiguously, each of the queue's
+ * item size. Implementations should move as many of them as possible under a
+ * single lock and wake the receiving side at most once, rather than paying the
+ * full per-item cost of dmosi_queue_send.
+ *
+ * @p timeout_ms bounds the wait for room for the first item only: once at least
+ * one item has been sent the call does not block again, and returns with a
+ * partial count when the queue fills up.
+ *
+ * @param queue Queue handle
+ * @param items Pointer to @p count contiguous items to send
+ * @param count Number of items to send
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int Number of items sent (1..count), or negative error code if none was sent
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_send_batch,    (dmosi_queue_t queue, const void* items, uint32_t count, int32_t timeout_ms) );
+
+/**
+ * @brief Receive several items from a queue in a single call
+ *
+ * Counterpart of dmosi_queue_send_batch: waits up to @p timeout_ms for the first
+ * item, then takes whatever else is already queued (up to @p max_count) without
+ * blocking again.
+ *
+ * @param queue Queue handle
+ * @param items Pointer to a buffer with room for @p max_count contiguous items
+ * @param max_count Maximum number of items to receive
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int Number of items received (1..max_count), or negative error code if none was received
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_receive_batch, (dmosi_queue_t queue, void* items, uint32_t max_count, int32_t timeout_ms) );
+
+/**
+ * @brief Reserve a free queue slot to build an item in place
+ *
+ * Zero-copy alternative to dmosi_queue_send: instead of copying an item into
+ * the queue storage, the caller gets a pointer to the next free slot, writes
+ * the item there directly and publishes it with dmosi_queue_commit_send. The
+ * item is not visible to receivers until it is committed.
+ *
+ * Only one reservation per queue may be outstanding at a time.
+ *
+ * @param queue Queue handle
+ * @param slot Set to the reserved slot (item_size bytes, writable until committed)
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_reserve_send,   (dmosi_queue_t queue, void** slot, int32_t timeout_ms) );
+
+/**
+ * @brief Publish a slot previously reserved with dmosi_queue_reserve_send
+ *
+ * @param queue Queue handle
+ * @param slot Slot returned by dmosi_queue_reserve_send
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_commit_send,    (dmosi_queue_t queue, void* slot) );
+
+/**
+ * @brief Get a pointer to the oldest queued item without copying it out
+ *
+ * Zero-copy alternative to dmosi_queue_receive: the item stays in the queue
+ * storage, and its slot is not reused until it is handed back with
+ * dmosi_queue_release_receive.
+ *
+ * Only one peeked slot per queue may be outstanding at a time.
+ *
+ * @param queue Queue handle
+ * @param slot Set to the oldest item (item_size bytes, readable until released)
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_peek_receive,   (dmosi_queue_t queue, const void** slot, int32_t timeout_ms) );
+
+/**
+ * @brief Remove an item previously obtained with dmosi_queue_peek_receive
+ *
+ * @param queue Queue handle
+ * @param slot Slot returned by dmosi_queue_peek_receive
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_release_receive, (dmosi_queue_t queue, const void* slot) );
+
+/** @} */ // end of DMOSI_QUEUE_API
+
+//==============================================================================
+//                              Message Buffer API
+//==============================================================================
+/**
+ * @defgroup DMOSI_MSGBUF_API Message Buffer API
+ * @brief API for variable-length message buffers in DMOD OSI
+ *
+ * A message buffer is a queue of variable-length messages. Each message is
+ * stored contiguously in a byte ring as a length prefix followed by its
+ * payload, so memory use follows the actual message sizes instead of a
+ * fixed worst-case slot size as with dmosi_queue_t. Messages are always
+ * delivered whole and in order.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for message buffer
+ *
+ * @note The actual implementation of the message buffer is hidden
+ * from the user and is specific to the underlying OS.
+ */
+typedef struct dmosi_msgbuf* dmosi_msgbuf_t;
+
+/**
+ * @brief Number of bytes of buffer space taken by each message's length prefix
+ *
+ * A message of N bytes occupies N + DMOSI_MSGBUF_LENGTH_PREFIX_SIZE bytes of
+ * the buffer size passed to dmosi_msgbuf_create.
+ */
+#define DMOSI_MSGBUF_LENGTH_PREFIX_SIZE     4
+
+/**
+ * @brief Create a message buffer
+ *
+ * @param buffer_size Total size of the byte ring in bytes, including length prefixes
+ * @return dmosi_msgbuf_t Created message buffer handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_msgbuf_t, _msgbuf_create,  (size_t buffer_size) );
+
+/**
+ * @brief Destroy a message buffer
+ *
+ * @param msgbuf Message buffer handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,           _msgbuf_destroy, (dmosi_msgbuf_t msgbuf) );
+
+/**
+ * @brief Send a message to a message buffer
+ *
+ * Blocks until there is room for the whole message (payload and length
+ * prefix); a message is never split or partially written.
+ *
+ * @param msgbuf Message buffer handle
+ * @param data Pointer to the message payload
+ * @param length Length of the message in bytes
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 on success, -EMSGSIZE if the message could never fit, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _msgbuf_send,    (dmosi_msgbuf_t msgbuf, const void* data, size_t length, int32_t timeout_ms) );
+
+/**
+ * @brief Receive the oldest message from a message buffer
+ *
+ * If @p buffer_size is too small for the oldest message, the call fails with
+ * -EMSGSIZE and the message is left in the buffer - use
+ * dmosi_msgbuf_next_length to size the receive buffer.
+ *
+ * @param msgbuf Message buffer handle
+ * @param buffer Pointer to buffer to receive the message payload
+ * @param buffer_size Size of @p buffer in bytes
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int Length of the received message in bytes, or negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,            _msgbuf_receive, (dmosi_msgbuf_t msgbuf, void* buffer, size_t buffer_size, int32_t timeout_ms) );
+
+/**
+ * @brief Get the length of the oldest message without receiving it
+ *
+ * @param msgbuf Message buffer handle
+ * @return size_t Length of the oldest message in bytes, 0 if the buffer is empty or on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, size_t,         _msgbuf_next_length, (dmosi_msgbuf_t msgbuf) );
+
+/** @} */ // end of DMOSI_MSGBUF_API
+
+//==============================================================================
+//                              Ring Buffer API
+//==============================================================================
+/**
+ * @defgroup DMOSI_RINGBUF_API Ring Buffer API
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * Unlike the Queue API, a ring buffer is not a kernel object: it lives in
+ * caller-provided memory, is implemented by dmosi itself on top of atomic
+ * loads and stores only, and behaves the same on every backend. It never
+ * blocks and never takes a lock, so both ends may be used from interrupt
+ * context - provided there is exactly one producer and one consumer.
+ * @{
+ */
+
+/**
+ * @brief Size of a cache line in bytes
+ *
+ * Used to keep the producer and consumer indices of a dmosi_ringbuf_t on
+ * separate cache lines. Define it before including dmosi.h (or on the
+ * compiler command line) to match the target; must be greater than 4.
+ */
+#ifndef DMOSI_CACHE_LINE_SIZE
+#   define DMOSI_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @brief Ring buffer control block
+ *
+ * Allocated by the caller (statically, on the stack or on the heap) and
+ * initialized with dmosi_ringbuf_init. The fields are private to dmosi.
+ */
+typedef struct {
+    uint32_t head;                                          /**< Producer index (written by producer only) */
+    uint8_t  head_pad[DMOSI_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    uint32_t tail;                                          /**< Consumer index (written by consumer only) */
+    uint8_t  tail_pad[DMOSI_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    uint8_t* storage;                                       /**< Item storage */
+    size_t   item_size;                                     /**< Size of each item in bytes */
+    uint32_t mask;                                          /**< Capacity - 1 */
+} dmosi_ringbuf_t;
+
 /**
- * @defgroup DMOSI_QUEUE_API Queue API
- * @brief API for queue operations in DMOD OSI
- * This API provides functions to create, destroy, and use queues.
- * @{
+ * @brief Number of storage bytes needed for a ring buffer
+ *
+ * @param item_size Size of each item in bytes
+ * @param capacity Number of items (must be a power of two)
  */
+#define DMOSI_RINGBUF_STORAGE_SIZE(item_size, capacity)    ((size_t)(item_size) * (size_t)(capacity))
 
 /**
- * @brief Opaque type for queue
+ * @brief Initialize a ring buffer
  *
- * This type represents a queue in the DMOD OSI system.
+ * Must be called before either end uses the ring buffer. There is no
+ * matching deinit - the ring buffer owns no resources of its own.
  *
- * @note The actual implementation of the queue is hidden
- * from the user and is specific to the underlying OS.
+ * @param ringbuf Ring buffer control block to initialize
+ * @param storage Caller-provided storage of DMOSI_RINGBUF_STORAGE_SIZE(item_size, capacity) bytes
+ * @param item_size Size of each item in bytes
+ * @param capacity Maximum number of items (must be a power of two)
+ * @return int 0 on success, -EINVAL on invalid arguments
  */
-typedef struct dmosi_queue* dmosi_queue_t;
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _ringbuf_init,    (dmosi_ringbuf_t* ringbuf, void* storage, size_t item_size, uint32_t capacity) );
 
 /**
- * @brief Create a queue
+ * @brief Push a single item (producer side)
  *
- * @param item_size Size of each item in the queue
- * @param queue_length Maximum number of items in the queue
- * @return dmosi_queue_t Created queue handle, NULL on failure
+ * @param ringbuf Ring buffer
+ * @param item Pointer to the item to copy in
+ * @return int 0 on success, -EAGAIN if the ring buffer is full
  */
-DMOD_BUILTIN_API( dmosi, 1.0, dmosi_queue_t, _queue_create,  (size_t item_size, uint32_t queue_length) );
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _ringbuf_push,    (dmosi_ringbuf_t* ringbuf, const void* item) );
 
 /**
- * @brief Destroy a queue
+ * @brief Pop a single item (consumer side)
  *
- * @param queue Queue handle to destroy
+ * @param ringbuf Ring buffer
+ * @param item Pointer to buffer to copy the item into
+ * @return int 0 on success, -EAGAIN if the ring buffer is empty
  */
-DMOD_BUILTIN_API( dmosi, 1.0, void,          _queue_destroy, (dmosi_queue_t queue) );
+DMOD_BUILTIN_API( dmosi, 1.0, int,           _ringbuf_pop,     (dmosi_ringbuf_t* ringbuf, void* item) );
 
 /**
- * @brief Send data to a queue
+ * @brief Push up to @p count contiguous items (producer side)
  *
- * @param queue Queue handle
- * @param item Pointer to the item to send
- * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
- * @return int 0 on success, negative error code on failure
+ * @param ringbuf Ring buffer
+ * @param items Pointer to @p count contiguous items
+ * @param count Number of items to push
+ * @return uint32_t Number of items actually pushed (less than @p count if the ring buffer filled up)
  */
-DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_send,    (dmosi_queue_t queue, const void* item, int32_t timeout_ms) );
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t,      _ringbuf_push_n,  (dmosi_ringbuf_t* ringbuf, const void* items, uint32_t count) );
 
 /**
- * @brief Receive data from a queue
+ * @brief Pop up to @p max_count contiguous items (consumer side)
  *
- * @param queue Queue handle
- * @param item Pointer to buffer to receive the item
- * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
- * @return int 0 on success, negative error code on failure
+ * @param ringbuf Ring buffer
+ * @param items Pointer to a buffer with room for @p max_count contiguous items
+ * @param max_count Maximum number of items to pop
+ * @return uint32_t Number of items actually popped
  */
-DMOD_BUILTIN_API( dmosi, 1.0, int,           _queue_receive, (dmosi_queue_t queue, void* item, int32_t timeout_ms) );
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t,      _ringbuf_pop_n,   (dmosi_ringbuf_t* ringbuf, void* items, uint32_t max_count) );
 
-/** @} */ // end of DMOSI_QUEUE_API
+/**
+ * @brief Get the number of items currently stored
+ *
+ * The result is a snapshot and may be stale by the time it is used if the
+ * other end is running concurrently.
+ *
+ * @param ringbuf Ring buffer
+ * @return uint32_t Number of items in the ring buffer
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, uint32_t,      _ringbuf_count,   (const dmosi_ringbuf_t* ringbuf) );
+
+/** @} */ // end of DMOSI_RINGBUF_API
 
 //==============================================================================
 //                              Timer API
@@ -915,6 +2269,35 @@ typedef void (*dmosi_timer_callback_t)(void* arg);
  */
 DMOD_BUILTIN_API( dmosi, 1.0, dmosi_timer_t, _timer_create,  (dmosi_timer_callback_t callback, void* arg, uint32_t period_ms, bool auto_reload) );
 
+/**
+ * @brief Size in bytes of the control block passed to dmosi_timer_create_static
+ *
+ * See DMOSI_MUTEX_STORAGE_SIZE for how this value may be overridden.
+ */
+#ifndef DMOSI_TIMER_STORAGE_SIZE
+#   define DMOSI_TIMER_STORAGE_SIZE     (24 * sizeof(void*))
+#endif
+
+/**
+ * @brief Caller-provided storage for a statically created timer
+ */
+typedef DMOSI_STATIC_STORAGE(DMOSI_TIMER_STORAGE_SIZE) dmosi_timer_storage_t;
+
+/**
+ * @brief Create a timer in caller-provided storage
+ *
+ * Same as dmosi_timer_create, but the control block lives in @p storage.
+ * See dmosi_mutex_create_static for the lifetime rules of the storage.
+ *
+ * @param callback Callback function to execute when timer expires
+ * @param arg Argument to pass to the callback function
+ * @param period_ms Timer period in milliseconds
+ * @param auto_reload Whether the timer should auto-reload
+ * @param storage Control block storage
+ * @return dmosi_timer_t Created timer handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_timer_t, _timer_create_static, (dmosi_timer_callback_t callback, void* arg, uint32_t period_ms, bool auto_reload, dmosi_timer_storage_t* storage) );
+
 /**
  * @brief Destroy a timer
  *
@@ -965,6 +2348,327 @@ DMOD_BUILTIN_API( dmosi, 1.0, uint32_t,      _timer_get_period, (dmosi_timer_t t
 
 /** @} */ // end of DMOSI_TIMER_API
 
+//==============================================================================
+//                              Wait Set API
+//==============================================================================
+/**
+ * @defgroup DMOSI_WAITSET_API Wait Set API
+ * @brief API for waiting on several kernel objects at once
+ *
+ * A wait set lets one thread block until any of its member queues,
+ * semaphores or timers becomes ready, instead of polling each of them in
+ * turn with short timeouts. The set only reports readiness - the caller then
+ * takes the data/count from the reported member itself, with a zero timeout.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for wait set
+ *
+ * @note The actual implementation of the wait set is hidden
+ * from the user and is specific to the underlying OS.
+ */
+typedef struct dmosi_waitset* dmosi_waitset_t;
+
+/**
+ * @brief Kind of object a wait set member refers to
+ */
+typedef enum {
+    DMOSI_WAITSET_MEMBER_QUEUE,     /**< dmosi_queue_t - ready when it holds at least one item */
+    DMOSI_WAITSET_MEMBER_SEMAPHORE, /**< dmosi_semaphore_t - ready when its count is non-zero */
+    DMOSI_WAITSET_MEMBER_TIMER      /**< dmosi_timer_t - ready once per expiry */
+} dmosi_waitset_member_type_t;
+
+/**
+ * @brief Wait set member descriptor
+ */
+typedef struct {
+    dmosi_waitset_member_type_t type;   /**< Kind of object */
+    void*                       object; /**< Object handle (dmosi_queue_t, dmosi_semaphore_t or dmosi_timer_t) */
+} dmosi_waitset_member_t;
+
+/**
+ * @brief Create a wait set
+ *
+ * @param max_members Maximum number of members the set can hold
+ * @return dmosi_waitset_t Created wait set handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_waitset_t, _waitset_create,  (uint32_t max_members) );
+
+/**
+ * @brief Destroy a wait set
+ *
+ * The member objects themselves are not destroyed.
+ *
+ * @param set Wait set handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,            _waitset_destroy, (dmosi_waitset_t set) );
+
+/**
+ * @brief Add an object to a wait set
+ *
+ * An object can be a member of at most one wait set at a time. Some
+ * implementations also require a queue to be empty, or a semaphore to have a
+ * zero count, at the time it is added.
+ *
+ * @param set Wait set handle
+ * @param type Kind of object being added
+ * @param object Object handle (dmosi_queue_t, dmosi_semaphore_t or dmosi_timer_t)
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,             _waitset_add,     (dmosi_waitset_t set, dmosi_waitset_member_type_t type, void* object) );
+
+/**
+ * @brief Remove an object from a wait set
+ *
+ * @param set Wait set handle
+ * @param object Object handle previously added with dmosi_waitset_add
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,             _waitset_remove,  (dmosi_waitset_t set, void* object) );
+
+/**
+ * @brief Wait until any member of a wait set becomes ready
+ *
+ * On success @p ready identifies one ready member. The caller is expected to
+ * consume it straight away (dmosi_queue_receive or dmosi_semaphore_wait with a
+ * zero timeout) before waiting on the set again; a member that is not consumed
+ * is reported again by the next call.
+ *
+ * @param set Wait set handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @param ready Filled with the member that became ready
+ * @return int 0 on success, -ETIMEDOUT if no member became ready in time, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,             _waitset_wait,    (dmosi_waitset_t set, int32_t timeout_ms, dmosi_waitset_member_t* ready) );
+
+/** @} */ // end of DMOSI_WAITSET_API
+
+//==============================================================================
+//                              Work Queue API
+//==============================================================================
+/**
+ * @defgroup DMOSI_WORKQUEUE_API Work Queue API
+ * @brief Shared worker threads for short jobs
+ *
+ * A work queue runs submitted jobs on a fixed set of worker threads, so many
+ * small jobs share a few stacks instead of each module creating threads of
+ * its own, and a job costs a list insertion rather than a thread start.
+ * Jobs are run in order of their due time (submission order for immediate
+ * ones) by whichever worker is free; with more than one worker, jobs may run
+ * concurrently.
+ *
+ * dmosi.c implements work queues generically on top of the thread, mutex
+ * and condition variable APIs. A backend that overrides one of these
+ * functions must override all of them.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for work queue
+ */
+typedef struct dmosi_workqueue* dmosi_workqueue_t;
+
+/**
+ * @brief Job function type
+ *
+ * @param arg Argument given at submission
+ */
+typedef void (*dmosi_work_fn_t)(void* arg);
+
+/**
+ * @brief Create a work queue and start its workers
+ *
+ * The workers belong to the calling process.
+ *
+ * @param worker_count Number of worker threads (must not be 0)
+ * @param priority Priority of the worker threads
+ * @param stack_size Stack size of each worker thread
+ * @param name Name of the worker threads (cannot be NULL)
+ * @return dmosi_workqueue_t Created work queue handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_workqueue_t, _workqueue_create, (uint32_t worker_count, int priority, size_t stack_size, const char* name) );
+
+/**
+ * @brief Destroy a work queue
+ *
+ * Jobs that have not started yet are discarded; jobs being run are waited
+ * for, then the workers are stopped and joined. Use dmosi_workqueue_drain
+ * first to run every pending job instead. Must not be called from a job of
+ * the same queue.
+ *
+ * @param workqueue Work queue handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,    _workqueue_destroy,        (dmosi_workqueue_t workqueue) );
+
+/**
+ * @brief Submit a job to be run as soon as a worker is free
+ *
+ * @param workqueue Work queue handle
+ * @param fn Job function
+ * @param arg Argument passed to @p fn
+ * @return int32_t Positive job id (for dmosi_workqueue_cancel), negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int32_t, _workqueue_submit,         (dmosi_workqueue_t workqueue, dmosi_work_fn_t fn, void* arg) );
+
+/**
+ * @brief Submit a job to be run after a delay
+ *
+ * @param workqueue Work queue handle
+ * @param fn Job function
+ * @param arg Argument passed to @p fn
+ * @param delay_ms Minimum delay before the job starts, in milliseconds
+ * @return int32_t Positive job id (for dmosi_workqueue_cancel), negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int32_t, _workqueue_submit_delayed, (dmosi_workqueue_t workqueue, dmosi_work_fn_t fn, void* arg, uint32_t delay_ms) );
+
+/**
+ * @brief Cancel a job that has not started yet
+ *
+ * @param workqueue Work queue handle
+ * @param id Job id returned by dmosi_workqueue_submit or _submit_delayed
+ * @return int 0 if the job was removed, -ENOENT if it has already started,
+ *         finished or is unknown, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,     _workqueue_cancel,         (dmosi_workqueue_t workqueue, int32_t id) );
+
+/**
+ * @brief Wait until a work queue is idle
+ *
+ * Waits until no job is pending - including delayed ones - and none is
+ * running. Jobs submitted in the meantime are waited for too. Must not be
+ * called from a job of the same queue.
+ *
+ * @param workqueue Work queue handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once idle, -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,     _workqueue_drain,          (dmosi_workqueue_t workqueue, int32_t timeout_ms) );
+
+/** @} */ // end of DMOSI_WORKQUEUE_API
+
+//==============================================================================
+//                              Task Pool API
+//==============================================================================
+/**
+ * @defgroup DMOSI_TASK_API Task Pool API
+ * @brief Work-stealing executor for CPU-bound fork-join work
+ *
+ * Unlike a work queue, a task pool has no shared queue for workers to
+ * contend on: each worker owns a deque of tasks, pushes and pops the tasks it
+ * spawns at one end, and idle workers steal from the other end of a randomly
+ * chosen victim. Tasks are meant to be short, non-blocking computations that
+ * split themselves into children (image tiles, FFT blocks, checksum
+ * batches...).
+ *
+ * A task completes once its function has returned and all of its children
+ * have completed, so waiting for a root task waits for the whole tree.
+ * Every task handle must be released exactly once, with dmosi_task_wait or
+ * dmosi_task_detach.
+ *
+ * dmosi.c implements task pools generically on top of the thread, mutex,
+ * condition variable and atomic APIs. A backend that overrides one of these
+ * functions must override all of them.
+ * @{
+ */
+
+/**
+ * @brief Opaque type for task pool
+ */
+typedef struct dmosi_task_pool* dmosi_task_pool_t;
+
+/**
+ * @brief Opaque type for task
+ */
+typedef struct dmosi_task* dmosi_task_t;
+
+/**
+ * @brief Task function type
+ *
+ * @param self Handle of the running task, to spawn children with
+ * @param arg Argument given to dmosi_task_spawn
+ */
+typedef void (*dmosi_task_fn_t)(dmosi_task_t self, void* arg);
+
+/**
+ * @brief Number of tasks each worker's deque can hold
+ *
+ * Must be a power of two. A task spawned on a worker whose deque is full is
+ * run straight away by the spawning thread instead.
+ */
+#ifndef DMOSI_TASK_DEQUE_SIZE
+#   define DMOSI_TASK_DEQUE_SIZE    256
+#endif
+
+/**
+ * @brief Create a task pool and start its workers
+ *
+ * The workers belong to the calling process. On multi-core targets, worker
+ * i is pinned to core (i % dmosi_get_core_count()), so workers don't
+ * migrate away from the caches holding their deques. Only the first
+ * DMOSI_CPU_MASK_BITS cores are used for pinning.
+ *
+ * @param worker_count Number of worker threads (0 = one per core, see dmosi_get_core_count)
+ * @param priority Priority of the worker threads
+ * @param stack_size Stack size of each worker thread
+ * @param name Name of the worker threads (cannot be NULL)
+ * @return dmosi_task_pool_t Created task pool handle, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_task_pool_t, _task_pool_create, (uint32_t worker_count, int priority, size_t stack_size, const char* name) );
+
+/**
+ * @brief Destroy a task pool
+ *
+ * Waits for every spawned task to complete, then stops and joins the
+ * workers. Must not be called from a task of the same pool.
+ *
+ * @param pool Task pool handle to destroy
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,         _task_pool_destroy, (dmosi_task_pool_t pool) );
+
+/**
+ * @brief Spawn a task
+ *
+ * Called from a worker of @p pool (typically from a task function), the task
+ * is pushed onto that worker's own deque; called from any other thread, it
+ * is queued for the first free worker.
+ *
+ * @param pool Task pool handle
+ * @param parent Task that the new task is a child of - @p parent does not
+ *               complete before it, and must not have completed yet, so
+ *               children are spawned from the parent's own function
+ *               (NULL for a root task)
+ * @param fn Task function
+ * @param arg Argument passed to @p fn
+ * @return dmosi_task_t Task handle, to be released with dmosi_task_wait or
+ *         dmosi_task_detach, NULL on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_task_t, _task_spawn,        (dmosi_task_pool_t pool, dmosi_task_t parent, dmosi_task_fn_t fn, void* arg) );
+
+/**
+ * @brief Wait for a task and its children to complete
+ *
+ * Called from a worker of the task's pool, runs other pending tasks while
+ * waiting instead of blocking the worker. On success the handle is released
+ * and must not be used anymore; on timeout it remains valid.
+ *
+ * @param task Task handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once the task has completed, -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, int,          _task_wait,         (dmosi_task_t task, int32_t timeout_ms) );
+
+/**
+ * @brief Release a task handle without waiting for the task
+ *
+ * The task still runs, and still delays the completion of its parent.
+ *
+ * @param task Task handle
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,         _task_detach,       (dmosi_task_t task) );
+
+/** @} */ // end of DMOSI_TASK_API
+
 //==============================================================================
 //                              Interrupt Handler API
 //==============================================================================
@@ -1051,8 +2755,439 @@ DMOD_BUILTIN_API( dmosi, 1.0, void, _tick_handler,            (void) );
  */
 DMOD_BUILTIN_API( dmosi, 1.0, uint32_t, _get_min_interrupt_priority, (void) );
 
+/**
+ * @brief Request a deferred context switch on exit from an ISR
+ *
+ * Call once, at the end of an ISR, with the flag accumulated from its
+ * _from_isr calls (see dmosi_semaphore_post_from_isr). If @p higher_priority_woken
+ * is true, the backend pends a context switch that runs as soon as the ISR
+ * returns (i.e. through dmosi_context_switch_handler - PendSV on ARM
+ * Cortex-M), so an ISR that posts several events still causes at most one
+ * switch. Does nothing if @p higher_priority_woken is false.
+ *
+ * @param higher_priority_woken Flag accumulated from the ISR's _from_isr calls
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void, _yield_from_isr, (bool higher_priority_woken) );
+
 /** @} */ // end of DMOSI_IRQ_API
 
+//==============================================================================
+//                              Critical Section API
+//==============================================================================
+/**
+ * @defgroup DMOSI_CRITICAL_API Critical Section API
+ * @brief Interrupt-safe protection of short sections of code
+ *
+ * For shared state updated in a few instructions, where a mutex would cost
+ * far more than the update itself, and for state shared with interrupt
+ * handlers, where a mutex cannot be used at all. Code inside a critical
+ * section or holding a spinlock must not block or call any dmosi function
+ * that may block.
+ * @{
+ */
+
+/**
+ * @brief Saved interrupt state returned by dmosi_critical_enter
+ */
+typedef uintptr_t dmosi_critical_state_t;
+
+/**
+ * @brief Enter a critical section
+ *
+ * Masks every interrupt allowed to call the dmosi API (see
+ * dmosi_get_min_interrupt_priority) and disables preemption on the current
+ * core, and returns the previous state. Critical sections nest: each
+ * dmosi_critical_exit restores the state saved by its matching enter, so
+ * interrupts are only re-enabled by the outermost exit. Can be called from
+ * interrupt context. Only protects against the current core - combine with a
+ * dmosi_spinlock_t for state shared between cores.
+ *
+ * @return dmosi_critical_state_t State to pass to the matching dmosi_critical_exit
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_critical_state_t, _critical_enter, (void) );
+
+/**
+ * @brief Leave a critical section
+ *
+ * @param state State returned by the matching dmosi_critical_enter
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,                   _critical_exit,  (dmosi_critical_state_t state) );
+
+/**
+ * @brief Spinlock for short sections shared between cores
+ *
+ * Must be initialized with DMOSI_SPINLOCK_INIT, or zeroed.
+ */
+typedef struct {
+    uint32_t locked;    //!< Internal state - do not access directly
+} dmosi_spinlock_t;
+
+/**
+ * @brief Static initializer for dmosi_spinlock_t
+ */
+#define DMOSI_SPINLOCK_INIT     { 0 }
+
+/**
+ * @brief Acquire a spinlock
+ *
+ * Enters a critical section (see dmosi_critical_enter), then busy-waits
+ * until the lock is free, so the holder can neither be preempted nor
+ * interrupted on its own core. Can be called from interrupt context.
+ * Spinlocks are not recursive.
+ *
+ * @param lock Spinlock to acquire
+ * @return dmosi_critical_state_t State to pass to the matching dmosi_spinlock_unlock
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, dmosi_critical_state_t, _spinlock_lock,   (dmosi_spinlock_t* lock) );
+
+/**
+ * @brief Release a spinlock and leave its critical section
+ *
+ * @param lock Spinlock to release
+ * @param state State returned by the matching dmosi_spinlock_lock
+ */
+DMOD_BUILTIN_API( dmosi, 1.0, void,                   _spinlock_unlock, (dmosi_spinlock_t* lock, dmosi_critical_state_t state) );
+
+/** @} */ // end of DMOSI_CRITICAL_API
+
+//==============================================================================
+//                              Atomic API
+//==============================================================================
+/**
+ * @defgroup DMOSI_ATOMIC_API Atomic API
+ * @brief Portable atomic operations on 32-bit words and pointers
+ *
+ * Header-only, so each operation inlines to the best sequence the target
+ * has: the compiler's __atomic builtins (LDREX/STREX, LR/SC, locked
+ * instructions...) where available, and a dmosi critical section around the
+ * read-modify-write operations on cores without atomic instructions
+ * (ARMv6-M, i.e. Cortex-M0/M0+) or compilers without the builtins. The
+ * latter can also be forced by defining DMOSI_ATOMIC_USE_CRITICAL_SECTION.
+ *
+ * @note In critical section mode the operations are only atomic with respect
+ *       to the current core. A backend for a multi-core target without atomic
+ *       instructions must make dmosi_critical_enter exclude the other cores.
+ * @{
+ */
+
+#if !defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION) && (defined(__ARM_ARCH_6M__) || !defined(__ATOMIC_RELAXED))
+#   define DMOSI_ATOMIC_USE_CRITICAL_SECTION
+#endif
+
+/**
+ * @brief Memory ordering constraints of atomic operations
+ *
+ * Same meaning as the C11 memory_order values.
+ */
+#if defined(__ATOMIC_RELAXED)
+typedef enum {
+    DMOSI_MEMORY_ORDER_RELAXED = __ATOMIC_RELAXED,  /**< Atomicity only, no ordering */
+    DMOSI_MEMORY_ORDER_ACQUIRE = __ATOMIC_ACQUIRE,  /**< Later accesses stay after this load */
+    DMOSI_MEMORY_ORDER_RELEASE = __ATOMIC_RELEASE,  /**< Earlier accesses stay before this store */
+    DMOSI_MEMORY_ORDER_ACQ_REL = __ATOMIC_ACQ_REL,  /**< Both, for read-modify-write operations */
+    DMOSI_MEMORY_ORDER_SEQ_CST = __ATOMIC_SEQ_CST,  /**< Single total order of all such operations */
+} dmosi_memory_order_t;
+#else
+typedef enum {
+    DMOSI_MEMORY_ORDER_RELAXED,
+    DMOSI_MEMORY_ORDER_ACQUIRE,
+    DMOSI_MEMORY_ORDER_RELEASE,
+    DMOSI_MEMORY_ORDER_ACQ_REL,
+    DMOSI_MEMORY_ORDER_SEQ_CST,
+} dmosi_memory_order_t;
+#endif
+
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+/**
+ * @brief Apply a read-modify-write operation to *ptr inside a critical section
+ *
+ * Internal helper of the critical section mode; the external calls act as
+ * compiler barriers, and the critical section keeps the update atomic.
+ */
+#   define DMOSI_ATOMIC_RMW_(type, ptr, new_value_expr)                       \
+        do {                                                                \
+            dmosi_critical_state_t dmosi_atomic_state_ = dmosi_critical_enter(); \
+            old = *(ptr);                                                   \
+            *(ptr) = (type)(new_value_expr);                                \
+            dmosi_critical_exit(dmosi_atomic_state_);                       \
+        } while (0)
+#endif
+
+/**
+ * @brief Issue a memory fence
+ *
+ * @param order Ordering the fence enforces
+ */
+static inline void dmosi_atomic_thread_fence(dmosi_memory_order_t order)
+{
+#if defined(__ATOMIC_RELAXED)
+    __atomic_thread_fence((int)order);
+#else
+    (void)order;
+    dmosi_critical_exit(dmosi_critical_enter());
+#endif
+}
+
+/**
+ * @brief Atomically load a 32-bit word
+ *
+ * @param ptr Word to load
+ * @param order DMOSI_MEMORY_ORDER_RELAXED, _ACQUIRE or _SEQ_CST
+ * @return uint32_t Loaded value
+ */
+static inline uint32_t dmosi_atomic_load_u32(const volatile uint32_t* ptr, dmosi_memory_order_t order)
+{
+#if defined(__ATOMIC_RELAXED)
+    return __atomic_load_n(ptr, (int)order);
+#else
+    // Aligned word loads are single-copy atomic; the fence provides the ordering
+    uint32_t value = *ptr;
+    dmosi_atomic_thread_fence(order);
+    return value;
+#endif
+}
+
+/**
+ * @brief Atomically store a 32-bit word
+ *
+ * @param ptr Word to store to
+ * @param value Value to store
+ * @param order DMOSI_MEMORY_ORDER_RELAXED, _RELEASE or _SEQ_CST
+ */
+static inline void dmosi_atomic_store_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(__ATOMIC_RELAXED)
+    __atomic_store_n(ptr, value, (int)order);
+#else
+    dmosi_atomic_thread_fence(order);
+    *ptr = value;
+#endif
+}
+
+/**
+ * @brief Atomically replace a 32-bit word
+ *
+ * @param ptr Word to modify
+ * @param value New value
+ * @param order Memory order of the operation
+ * @return uint32_t Previous value
+ */
+static inline uint32_t dmosi_atomic_exchange_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    uint32_t old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(uint32_t, ptr, value);
+    return old;
+#else
+    return __atomic_exchange_n(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically compare and exchange a 32-bit word
+ *
+ * If *@p ptr equals *@p expected, stores @p desired into it; otherwise
+ * loads its current value into *@p expected. Never fails spuriously.
+ *
+ * @param ptr Word to modify
+ * @param expected Expected value, updated with the current one on failure
+ * @param desired Value to store on success
+ * @param success Memory order if the exchange happens
+ * @param failure Memory order of the load on failure (not stronger than @p success)
+ * @return bool true if @p desired was stored
+ */
+static inline bool dmosi_atomic_compare_exchange_u32(volatile uint32_t* ptr, uint32_t* expected, uint32_t desired,
+                                                     dmosi_memory_order_t success, dmosi_memory_order_t failure)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    (void)success;
+    (void)failure;
+    dmosi_critical_state_t state = dmosi_critical_enter();
+    uint32_t current = *ptr;
+    bool exchanged = (current == *expected);
+    if (exchanged) {
+        *ptr = desired;
+    } else {
+        *expected = current;
+    }
+    dmosi_critical_exit(state);
+    return exchanged;
+#else
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, (int)success, (int)failure);
+#endif
+}
+
+/**
+ * @brief Atomically add to a 32-bit word (wrapping)
+ *
+ * @param ptr Word to modify
+ * @param value Value to add
+ * @param order Memory order of the operation
+ * @return uint32_t Previous value
+ */
+static inline uint32_t dmosi_atomic_fetch_add_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    uint32_t old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(uint32_t, ptr, old + value);
+    return old;
+#else
+    return __atomic_fetch_add(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically subtract from a 32-bit word (wrapping)
+ *
+ * @param ptr Word to modify
+ * @param value Value to subtract
+ * @param order Memory order of the operation
+ * @return uint32_t Previous value
+ */
+static inline uint32_t dmosi_atomic_fetch_sub_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    uint32_t old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(uint32_t, ptr, old - value);
+    return old;
+#else
+    return __atomic_fetch_sub(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically OR bits into a 32-bit word
+ *
+ * @param ptr Word to modify
+ * @param value Bits to set
+ * @param order Memory order of the operation
+ * @return uint32_t Previous value
+ */
+static inline uint32_t dmosi_atomic_fetch_or_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    uint32_t old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(uint32_t, ptr, old | value);
+    return old;
+#else
+    return __atomic_fetch_or(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically AND a mask into a 32-bit word
+ *
+ * @param ptr Word to modify
+ * @param value Mask of bits to keep
+ * @param order Memory order of the operation
+ * @return uint32_t Previous value
+ */
+static inline uint32_t dmosi_atomic_fetch_and_u32(volatile uint32_t* ptr, uint32_t value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    uint32_t old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(uint32_t, ptr, old & value);
+    return old;
+#else
+    return __atomic_fetch_and(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically load a pointer
+ *
+ * @param ptr Pointer variable to load
+ * @param order DMOSI_MEMORY_ORDER_RELAXED, _ACQUIRE or _SEQ_CST
+ * @return void* Loaded pointer
+ */
+static inline void* dmosi_atomic_load_ptr(void* const volatile* ptr, dmosi_memory_order_t order)
+{
+#if defined(__ATOMIC_RELAXED)
+    return __atomic_load_n(ptr, (int)order);
+#else
+    void* value = *ptr;
+    dmosi_atomic_thread_fence(order);
+    return value;
+#endif
+}
+
+/**
+ * @brief Atomically store a pointer
+ *
+ * @param ptr Pointer variable to store to
+ * @param value Pointer to store
+ * @param order DMOSI_MEMORY_ORDER_RELAXED, _RELEASE or _SEQ_CST
+ */
+static inline void dmosi_atomic_store_ptr(void* volatile* ptr, void* value, dmosi_memory_order_t order)
+{
+#if defined(__ATOMIC_RELAXED)
+    __atomic_store_n(ptr, value, (int)order);
+#else
+    dmosi_atomic_thread_fence(order);
+    *ptr = value;
+#endif
+}
+
+/**
+ * @brief Atomically replace a pointer
+ *
+ * @param ptr Pointer variable to modify
+ * @param value New pointer
+ * @param order Memory order of the operation
+ * @return void* Previous pointer
+ */
+static inline void* dmosi_atomic_exchange_ptr(void* volatile* ptr, void* value, dmosi_memory_order_t order)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    void* old;
+    (void)order;
+    DMOSI_ATOMIC_RMW_(void*, ptr, value);
+    return old;
+#else
+    return __atomic_exchange_n(ptr, value, (int)order);
+#endif
+}
+
+/**
+ * @brief Atomically compare and exchange a pointer
+ *
+ * See dmosi_atomic_compare_exchange_u32.
+ *
+ * @param ptr Pointer variable to modify
+ * @param expected Expected pointer, updated with the current one on failure
+ * @param desired Pointer to store on success
+ * @param success Memory order if the exchange happens
+ * @param failure Memory order of the load on failure
+ * @return bool true if @p desired was stored
+ */
+static inline bool dmosi_atomic_compare_exchange_ptr(void* volatile* ptr, void** expected, void* desired,
+                                                     dmosi_memory_order_t success, dmosi_memory_order_t failure)
+{
+#if defined(DMOSI_ATOMIC_USE_CRITICAL_SECTION)
+    (void)success;
+    (void)failure;
+    dmosi_critical_state_t state = dmosi_critical_enter();
+    void* current = *ptr;
+    bool exchanged = (current == *expected);
+    if (exchanged) {
+        *ptr = desired;
+    } else {
+        *expected = current;
+    }
+    dmosi_critical_exit(state);
+    return exchanged;
+#else
+    return __atomic_compare_exchange_n(ptr, expected, desired, false, (int)success, (int)failure);
+#endif
+}
+
+/** @} */ // end of DMOSI_ATOMIC_API
+
 //==============================================================================
 //                              System Time API
 //==============================================================================
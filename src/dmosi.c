@@ -1,4 +1,5 @@
 #include <errno.h>
+#include <string.h>
 #include "dmod.h"
 #include "dmosi.h"
 
@@ -46,1093 +47,3951 @@ DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, bool, _is_started, (void) )
 }
 
 //==============================================================================
-//                              MUTEX API
+//                              Reader-Writer Lock API
 //==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_mutex_create
+ * @brief Default (weak) implementation of dmosi_rwlock_create
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param recursive Whether the mutex should be recursive (unused)
- * @return dmosi_mutex_t Always NULL
+ * @return dmosi_rwlock_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_mutex_t, _mutex_create,    (bool recursive) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_rwlock_t, _rwlock_create,       (void) )
 {
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_mutex_destroy
+ * @brief Default (weak) implementation of dmosi_rwlock_destroy
  *
  * Overridden by the platform-specific dmosi backend. This default is a no-op,
  * used when no backend has been linked in.
  *
- * @param mutex Mutex handle to destroy (unused)
+ * @param rwlock Lock handle to destroy (unused)
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _mutex_destroy,   (dmosi_mutex_t mutex) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _rwlock_destroy,      (dmosi_rwlock_t rwlock) )
 {
-    (void)mutex;
+    (void)rwlock;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_mutex_lock
+ * @brief Default (weak) implementation of dmosi_rwlock_read_lock
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param mutex Mutex handle to lock (unused)
+ * @param rwlock Lock handle (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _mutex_lock,      (dmosi_mutex_t mutex) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _rwlock_read_lock,    (dmosi_rwlock_t rwlock, int32_t timeout_ms) )
 {
-    (void)mutex;
+    (void)rwlock;
+    (void)timeout_ms;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_mutex_unlock
+ * @brief Default (weak) implementation of dmosi_rwlock_read_unlock
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param mutex Mutex handle to unlock (unused)
+ * @param rwlock Lock handle (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _mutex_unlock,    (dmosi_mutex_t mutex) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _rwlock_read_unlock,  (dmosi_rwlock_t rwlock) )
 {
-    (void)mutex;
+    (void)rwlock;
     return -ENOSYS;
 }
 
-//==============================================================================
-//                              Semaphore API
-//==============================================================================
-/**
- * @brief Default (weak) implementation of dmosi_semaphore_create
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param initial_count Initial count for the semaphore (unused)
- * @param max_count Maximum count for the semaphore (unused)
- * @return dmosi_semaphore_t Always NULL
- */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_semaphore_t, _semaphore_create,  (uint32_t initial_count, uint32_t max_count) )
-{
-    (void)initial_count;
-    (void)max_count;
-    return NULL;
-}
-
-/**
- * @brief Default (weak) implementation of dmosi_semaphore_destroy
- *
- * Overridden by the platform-specific dmosi backend. This default is a no-op,
- * used when no backend has been linked in.
- *
- * @param semaphore Semaphore handle to destroy (unused)
- */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _semaphore_destroy, (dmosi_semaphore_t semaphore) )
-{
-    (void)semaphore;
-}
-
 /**
- * @brief Default (weak) implementation of dmosi_semaphore_wait
+ * @brief Default (weak) implementation of dmosi_rwlock_write_lock
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param semaphore Semaphore handle (unused)
- * @param count Number of semaphore units to take (unused)
+ * @param rwlock Lock handle (unused)
  * @param timeout_ms Timeout in milliseconds (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 2.0, int, _semaphore_wait,    (dmosi_semaphore_t semaphore, uint32_t count, int32_t timeout_ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _rwlock_write_lock,   (dmosi_rwlock_t rwlock, int32_t timeout_ms) )
 {
-    (void)semaphore;
-    (void)count;
+    (void)rwlock;
     (void)timeout_ms;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_semaphore_post
+ * @brief Default (weak) implementation of dmosi_rwlock_write_unlock
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param semaphore Semaphore handle (unused)
- * @param count Number of semaphore units to release (unused)
+ * @param rwlock Lock handle (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 2.0, int, _semaphore_post,    (dmosi_semaphore_t semaphore, uint32_t count) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _rwlock_write_unlock, (dmosi_rwlock_t rwlock) )
 {
-    (void)semaphore;
-    (void)count;
+    (void)rwlock;
     return -ENOSYS;
 }
 
 //==============================================================================
-//                              Thread API
+//                              Condition Variable API
 //==============================================================================
+/*
+ * Generic implementation for backends without a native condition variable,
+ * built on a dmosi_mutex_t and one binary dmosi_semaphore_t per waiter.
+ * Backends with a native one override all of these functions together.
+ *
+ * Every dmosi_cond_wait queues a waiter node of its own, under the internal
+ * lock and before the caller's mutex is released. A signal takes the oldest
+ * node off the queue, marks it and posts its semaphore; a broadcast does so
+ * for every queued node. A wakeup is thus tied to one particular wait and
+ * can never be taken by a thread that starts waiting after it was issued -
+ * not even by a woken thread that immediately waits again. A waiter that
+ * times out checks under the lock whether it was signalled in the meantime
+ * and, if so, takes its post and reports success instead.
+ *
+ * Nodes are kept on a free list in the condition variable once used, so
+ * after the first waits no semaphore is created per dmosi_cond_wait.
+ */
+
 /**
- * @brief Default (weak) implementation of dmosi_thread_create
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param entry Entry function for the thread (unused)
- * @param arg Argument to pass to the entry function (unused)
- * @param priority Thread priority (unused)
- * @param stack_size Stack size for the thread (unused)
- * @param name Name of the thread (unused)
- * @param process Process to associate the thread with (unused)
- * @return dmosi_thread_t Always NULL
+ * @brief Waiter node of the generic condition variable
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_t, _thread_create,    (dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process) )
+struct dmosi_cond_waiter {
+    struct dmosi_cond_waiter*   next;       //!< Next node in the wait queue or free list
+    dmosi_semaphore_t           wakeup;     //!< Posted once when this waiter is signalled
+    bool                        signalled;  //!< Taken off the queue by a signal or broadcast
+};
+
+/**
+ * @brief Control block of the generic condition variable
+ */
+struct dmosi_cond {
+    dmosi_mutex_t               lock;       //!< Protects the queue and the free list
+    struct dmosi_cond_waiter*   head;       //!< Oldest waiter not yet signalled
+    struct dmosi_cond_waiter*   tail;       //!< Newest waiter not yet signalled
+    struct dmosi_cond_waiter*   free;       //!< Nodes of finished waits, for reuse
+};
+
+/**
+ * @brief Wake a waiter taken off the queue - only while holding cond->lock
+ */
+static int dmosi_cond_wake(struct dmosi_cond_waiter* waiter)
 {
-    (void)entry;
-    (void)arg;
-    (void)priority;
-    (void)stack_size;
-    (void)name;
-    (void)process;
-    return NULL;
+    waiter->signalled = true;
+    return dmosi_semaphore_post(waiter->wakeup, 1);
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_destroy
- *
- * Overridden by the platform-specific dmosi backend. This default is a no-op,
- * used when no backend has been linked in.
+ * @brief Generic implementation of dmosi_cond_create
  *
- * @param thread Thread handle to destroy (unused)
+ * @return dmosi_cond_t Created condition variable handle, NULL on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _thread_destroy,   (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_cond_t, _cond_create,    (void) )
 {
-    (void)thread;
+    struct dmosi_cond* cond = Dmod_Malloc(sizeof(struct dmosi_cond));
+    if (cond == NULL) {
+        return NULL;
+    }
+
+    cond->lock = dmosi_mutex_create(false);
+    cond->head = NULL;
+    cond->tail = NULL;
+    cond->free = NULL;
+    if (cond->lock == NULL) {
+        Dmod_Free(cond);
+        return NULL;
+    }
+    return cond;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_join
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_cond_destroy
  *
- * @param thread Thread handle to join (unused)
- * @return int Always -ENOSYS
+ * @param cond Condition variable handle to destroy
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_join,      (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _cond_destroy,   (dmosi_cond_t cond) )
 {
-    (void)thread;
-    return -ENOSYS;
+    if (cond == NULL) {
+        return;
+    }
+    while (cond->free != NULL) {
+        struct dmosi_cond_waiter* waiter = cond->free;
+        cond->free = waiter->next;
+        dmosi_semaphore_destroy(waiter->wakeup);
+        Dmod_Free(waiter);
+    }
+    dmosi_mutex_destroy(cond->lock);
+    Dmod_Free(cond);
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_kill
+ * @brief Generic implementation of dmosi_cond_wait
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param thread Thread handle to kill (unused)
- * @param status Exit status code (unused)
- * @return int Always -ENOSYS
+ * @param cond Condition variable handle
+ * @param mutex Mutex protecting the predicate
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 when woken, -ETIMEDOUT on timeout, other negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_kill,      (dmosi_thread_t thread, int status) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _cond_wait,      (dmosi_cond_t cond, dmosi_mutex_t mutex, int32_t timeout_ms) )
 {
-    (void)thread;
-    (void)status;
-    return -ENOSYS;
+    if (cond == NULL || mutex == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(cond->lock);
+    if (result != 0) {
+        return result;
+    }
+
+    struct dmosi_cond_waiter* waiter = cond->free;
+    if (waiter != NULL) {
+        cond->free = waiter->next;
+    } else {
+        waiter = Dmod_Malloc(sizeof(struct dmosi_cond_waiter));
+        if (waiter != NULL) {
+            waiter->wakeup = dmosi_semaphore_create(0, 1);
+            if (waiter->wakeup == NULL) {
+                Dmod_Free(waiter);
+                waiter = NULL;
+            }
+        }
+        if (waiter == NULL) {
+            dmosi_mutex_unlock(cond->lock);
+            return -ENOMEM;
+        }
+    }
+
+    waiter->next      = NULL;
+    waiter->signalled = false;
+    if (cond->tail != NULL) {
+        cond->tail->next = waiter;
+    } else {
+        cond->head = waiter;
+    }
+    cond->tail = waiter;
+    dmosi_mutex_unlock(cond->lock);
+
+    // Queued before the caller's mutex is released, so a signal issued right
+    // after that already finds this waiter.
+    dmosi_mutex_unlock(mutex);
+    result = dmosi_semaphore_wait(waiter->wakeup, 1, timeout_ms);
+
+    dmosi_mutex_lock(cond->lock);
+    if (result != 0) {
+        if (waiter->signalled) {
+            // Signalled between the timeout and taking the lock: the post is
+            // already made (under this lock), take it so the node is clean
+            dmosi_semaphore_wait(waiter->wakeup, 1, 0);
+            result = 0;
+        } else {
+            struct dmosi_cond_waiter** link = &cond->head;
+            struct dmosi_cond_waiter*  prev = NULL;
+            while (*link != waiter) {
+                prev = *link;
+                link = &(*link)->next;
+            }
+            *link = waiter->next;
+            if (cond->tail == waiter) {
+                cond->tail = prev;
+            }
+            result = (timeout_ms == 0 || result == -ETIMEDOUT) ? -ETIMEDOUT : result;
+        }
+    }
+    waiter->next = cond->free;
+    cond->free   = waiter;
+    dmosi_mutex_unlock(cond->lock);
+
+    dmosi_mutex_lock(mutex);
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_current
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_cond_signal
  *
- * @return dmosi_thread_t Always NULL
+ * @param cond Condition variable handle
+ * @return int 0 on success, negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_t, _thread_current,   (void) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _cond_signal,    (dmosi_cond_t cond) )
 {
-    return NULL;
+    if (cond == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(cond->lock);
+    if (result != 0) {
+        return result;
+    }
+    struct dmosi_cond_waiter* waiter = cond->head;
+    if (waiter != NULL) {
+        cond->head = waiter->next;
+        if (cond->head == NULL) {
+            cond->tail = NULL;
+        }
+        result = dmosi_cond_wake(waiter);
+    }
+    dmosi_mutex_unlock(cond->lock);
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_sleep
+ * @brief Generic implementation of dmosi_cond_broadcast
  *
- * Overridden by the platform-specific dmosi backend. This default is a no-op,
- * used when no backend has been linked in.
- *
- * @param ms Time to sleep in milliseconds (unused)
+ * @param cond Condition variable handle
+ * @return int 0 on success, negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _thread_sleep,     (uint32_t ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _cond_broadcast, (dmosi_cond_t cond) )
 {
-    (void)ms;
+    if (cond == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(cond->lock);
+    if (result != 0) {
+        return result;
+    }
+    struct dmosi_cond_waiter* waiter = cond->head;
+    cond->head = NULL;
+    cond->tail = NULL;
+    while (waiter != NULL) {
+        struct dmosi_cond_waiter* next = waiter->next;
+        int wake_result = dmosi_cond_wake(waiter);
+        if (wake_result != 0) {
+            result = wake_result;
+        }
+        waiter = next;
+    }
+    dmosi_mutex_unlock(cond->lock);
+    return result;
 }
 
+//==============================================================================
+//                              Barrier, Latch and Once API
+//==============================================================================
+/*
+ * Generic implementations on top of the mutex, semaphore and address wait
+ * APIs. The barrier alternates between two semaphores by phase parity, so the
+ * last thread to arrive releases the whole phase with a single post, and a
+ * fast thread already waiting in the next phase can never take a post meant
+ * for the previous one.
+ */
+
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_name
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Maximum count of the semaphore a generic latch releases its waiters with
+ */
+#define DMOSI_LATCH_SEMAPHORE_MAX_COUNT 0x7FFFFFFFu
+
+/**
+ * @brief Control block of the generic barrier
+ */
+struct dmosi_barrier {
+    dmosi_mutex_t     lock;     //!< Protects arrived and phase
+    dmosi_semaphore_t gate[2];  //!< Waiters of even / odd phases
+    uint32_t          count;    //!< Participants per phase
+    uint32_t          arrived;  //!< Threads arrived in the current phase
+    uint32_t          phase;    //!< Current phase number
+};
+
+/**
+ * @brief Control block of the generic latch
+ */
+struct dmosi_latch {
+    dmosi_mutex_t     lock;     //!< Protects count and waiters
+    dmosi_semaphore_t gate;     //!< Posted once per waiter when count reaches zero
+    uint32_t          count;    //!< Remaining count
+    uint32_t          waiters;  //!< Threads sleeping in dmosi_latch_wait
+};
+
+/**
+ * @brief Generic implementation of dmosi_barrier_create
  *
- * @param thread Thread handle (unused)
- * @return const char* Always NULL
+ * @param count Number of threads that take part in each phase
+ * @return dmosi_barrier_t Created barrier handle, NULL on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _thread_get_name,  (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_barrier_t, _barrier_create,  (uint32_t count) )
 {
-    (void)thread;
-    return NULL;
+    if (count == 0) {
+        return NULL;
+    }
+
+    struct dmosi_barrier* barrier = Dmod_Malloc(sizeof(struct dmosi_barrier));
+    if (barrier == NULL) {
+        return NULL;
+    }
+
+    barrier->lock    = dmosi_mutex_create(false);
+    barrier->gate[0] = dmosi_semaphore_create(0, count);
+    barrier->gate[1] = dmosi_semaphore_create(0, count);
+    barrier->count   = count;
+    barrier->arrived = 0;
+    barrier->phase   = 0;
+    if (barrier->lock == NULL || barrier->gate[0] == NULL || barrier->gate[1] == NULL) {
+        dmosi_barrier_destroy(barrier);
+        return NULL;
+    }
+    return barrier;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_module_name
+ * @brief Generic implementation of dmosi_barrier_destroy
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param thread Thread handle (unused)
- * @return const char* Always NULL
+ * @param barrier Barrier handle to destroy
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _thread_get_module_name,  (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _barrier_destroy, (dmosi_barrier_t barrier) )
 {
-    (void)thread;
-    return NULL;
+    if (barrier == NULL) {
+        return;
+    }
+    if (barrier->gate[0] != NULL) {
+        dmosi_semaphore_destroy(barrier->gate[0]);
+    }
+    if (barrier->gate[1] != NULL) {
+        dmosi_semaphore_destroy(barrier->gate[1]);
+    }
+    if (barrier->lock != NULL) {
+        dmosi_mutex_destroy(barrier->lock);
+    }
+    Dmod_Free(barrier);
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_priority
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_barrier_wait
  *
- * @param thread Thread handle (unused)
- * @return int Always 0
+ * @param barrier Barrier handle
+ * @return int DMOSI_BARRIER_SERIAL_THREAD, 0, or negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_get_priority,  (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _barrier_wait,    (dmosi_barrier_t barrier) )
 {
-    (void)thread;
-    return 0;
+    if (barrier == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(barrier->lock);
+    if (result != 0) {
+        return result;
+    }
+
+    uint32_t          phase = barrier->phase;
+    dmosi_semaphore_t gate  = barrier->gate[phase & 1u];
+    if (barrier->arrived + 1 == barrier->count) {
+        // Release the others before completing the phase, so that a failed
+        // post leaves the barrier as it was and the call can be retried
+        if (barrier->count > 1) {
+            result = dmosi_semaphore_post(gate, barrier->count - 1);
+        }
+        if (result == 0) {
+            barrier->arrived = 0;
+            barrier->phase++;
+            result = DMOSI_BARRIER_SERIAL_THREAD;
+        }
+        dmosi_mutex_unlock(barrier->lock);
+        return result;
+    }
+    barrier->arrived++;
+    dmosi_mutex_unlock(barrier->lock);
+
+    result = dmosi_semaphore_wait(gate, 1, -1);
+    if (result != 0) {
+        dmosi_mutex_lock(barrier->lock);
+        if (barrier->phase == phase) {
+            // Still waiting for others: withdraw the arrival
+            barrier->arrived--;
+        } else if (dmosi_semaphore_wait(gate, 1, 0) == 0) {
+            // Completed meanwhile: take the post issued for this thread, so it
+            // cannot release a waiter of the next phase of the same parity
+            result = 0;
+        }
+        dmosi_mutex_unlock(barrier->lock);
+    }
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_process
+ * @brief Generic implementation of dmosi_latch_create
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param thread Thread handle (unused)
- * @return dmosi_process_t Always NULL
+ * @param count Initial count
+ * @return dmosi_latch_t Created latch handle, NULL on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _thread_get_process, (dmosi_thread_t thread) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_latch_t, _latch_create,     (uint32_t count) )
 {
-    (void)thread;
-    return NULL;
+    struct dmosi_latch* latch = Dmod_Malloc(sizeof(struct dmosi_latch));
+    if (latch == NULL) {
+        return NULL;
+    }
+
+    latch->lock    = dmosi_mutex_create(false);
+    latch->gate    = dmosi_semaphore_create(0, DMOSI_LATCH_SEMAPHORE_MAX_COUNT);
+    latch->count   = count;
+    latch->waiters = 0;
+    if (latch->lock == NULL || latch->gate == NULL) {
+        dmosi_latch_destroy(latch);
+        return NULL;
+    }
+    return latch;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_all
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_latch_destroy
  *
- * @param threads Pointer to array to fill with thread handles (unused)
- * @param max_count Maximum number of handles to write (unused)
- * @return size_t Always 0
+ * @param latch Latch handle to destroy
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _thread_get_all, (dmosi_thread_t* threads, size_t max_count) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _latch_destroy,    (dmosi_latch_t latch) )
 {
-    (void)threads;
-    (void)max_count;
-    return 0;
+    if (latch == NULL) {
+        return;
+    }
+    if (latch->gate != NULL) {
+        dmosi_semaphore_destroy(latch->gate);
+    }
+    if (latch->lock != NULL) {
+        dmosi_mutex_destroy(latch->lock);
+    }
+    Dmod_Free(latch);
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_by_process
+ * @brief Generic implementation of dmosi_latch_count_down
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param process Process handle whose threads to retrieve (unused)
- * @param threads Pointer to array to fill with thread handles (unused)
- * @param max_count Maximum number of handles to write (unused)
- * @return size_t Always 0
+ * @param latch Latch handle
+ * @param count Amount to subtract from the count
+ * @return int 0 on success, negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _thread_get_by_process, (dmosi_process_t process, dmosi_thread_t* threads, size_t max_count) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _latch_count_down, (dmosi_latch_t latch, uint32_t count) )
 {
-    (void)process;
-    (void)threads;
-    (void)max_count;
-    return 0;
+    if (latch == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(latch->lock);
+    if (result != 0) {
+        return result;
+    }
+    if (latch->count > 0) {
+        latch->count = (count >= latch->count) ? 0 : latch->count - count;
+        if (latch->count == 0 && latch->waiters > 0) {
+            result = dmosi_semaphore_post(latch->gate, latch->waiters);
+            latch->waiters = 0;
+        }
+    }
+    dmosi_mutex_unlock(latch->lock);
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_get_info
- *
- * Overridden by the platform-specific dmosi backend. This default fills @p info
- * with zeroed/terminated values and reports failure, used when no backend has
- * been linked in.
+ * @brief Generic implementation of dmosi_latch_wait
  *
- * @param thread Thread handle (unused)
- * @param info Pointer to a dmosi_thread_info_t structure to fill
- * @return int -EINVAL if @p info is NULL, otherwise -ENOSYS
+ * @param latch Latch handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once the count is zero, -ETIMEDOUT on timeout, other negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_get_info, (dmosi_thread_t thread, dmosi_thread_info_t* info) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _latch_wait,       (dmosi_latch_t latch, int32_t timeout_ms) )
 {
-    (void)thread;
-    if (info == NULL) {
+    if (latch == NULL) {
         return -EINVAL;
     }
-    info->stack_total   = 0;
-    info->stack_current = 0;
-    info->stack_peak    = 0;
-    info->state         = DMOSI_THREAD_STATE_TERMINATED;
-    info->cpu_usage     = 0.0f;
-    info->runtime_ms    = 0;
-    return -ENOSYS;
+
+    int result = dmosi_mutex_lock(latch->lock);
+    if (result != 0) {
+        return result;
+    }
+    if (latch->count == 0) {
+        dmosi_mutex_unlock(latch->lock);
+        return 0;
+    }
+    if (timeout_ms == 0) {
+        dmosi_mutex_unlock(latch->lock);
+        return -ETIMEDOUT;
+    }
+    latch->waiters++;
+    dmosi_mutex_unlock(latch->lock);
+
+    uint32_t start = dmosi_get_tick_count();
+    result = dmosi_semaphore_wait(latch->gate, 1, timeout_ms);
+    if (result != 0) {
+        dmosi_mutex_lock(latch->lock);
+        if (latch->count == 0) {
+            // Opened between the timeout and taking the lock: the post
+            // issued for this thread is already in the semaphore
+            dmosi_semaphore_wait(latch->gate, 1, 0);
+            result = 0;
+        } else {
+            latch->waiters--;
+            // Backends differ in the code they report an expired wait with
+            if (timeout_ms > 0 && (int32_t)(dmosi_get_tick_count() - start) >= timeout_ms) {
+                result = -ETIMEDOUT;
+            }
+        }
+        dmosi_mutex_unlock(latch->lock);
+    }
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_thread_register_exit_callback
+ * @brief States of dmosi_once_t
+ */
+enum {
+    DMOSI_ONCE_STATE_INIT    = 0,   //!< fn has not been called yet
+    DMOSI_ONCE_STATE_RUNNING = 1,   //!< fn is being run by another thread
+    DMOSI_ONCE_STATE_DONE    = 2,   //!< fn has returned
+};
+
+/**
+ * @brief Generic implementation of dmosi_once
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Threads that lose the race sleep on the flag with dmosi_wait_on_address,
+ * or poll it every millisecond if the backend doesn't provide that.
  *
- * @param thread Thread handle to observe (unused)
- * @param callback Callback function to invoke on thread exit (unused)
- * @param arg User-provided argument passed to the callback (unused)
- * @return dmosi_thread_exit_callback_handle_t Always NULL
+ * @param once One-time initialization flag
+ * @param fn Function to run
+ * @return int 0 on success, negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_exit_callback_handle_t, _thread_register_exit_callback,   (dmosi_thread_t thread, dmosi_thread_exit_callback_t callback, void* arg) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _once, (dmosi_once_t* once, dmosi_once_fn_t fn) )
 {
-    (void)thread;
-    (void)callback;
-    (void)arg;
-    return NULL;
+    if (once == NULL || fn == NULL) {
+        return -EINVAL;
+    }
+
+    uint32_t state = dmosi_atomic_load_u32(&once->state, DMOSI_MEMORY_ORDER_ACQUIRE);
+    if (state == DMOSI_ONCE_STATE_DONE) {
+        return 0;
+    }
+
+    state = DMOSI_ONCE_STATE_INIT;
+    if (dmosi_atomic_compare_exchange_u32(&once->state, &state, DMOSI_ONCE_STATE_RUNNING, DMOSI_MEMORY_ORDER_ACQUIRE, DMOSI_MEMORY_ORDER_ACQUIRE)) {
+        fn();
+        dmosi_atomic_store_u32(&once->state, DMOSI_ONCE_STATE_DONE, DMOSI_MEMORY_ORDER_RELEASE);
+        dmosi_wake_address(&once->state, DMOSI_WAKE_ALL);
+        return 0;
+    }
+
+    while (dmosi_atomic_load_u32(&once->state, DMOSI_MEMORY_ORDER_ACQUIRE) != DMOSI_ONCE_STATE_DONE) {
+        if (dmosi_wait_on_address(&once->state, DMOSI_ONCE_STATE_RUNNING, -1) == -ENOSYS) {
+            dmosi_thread_sleep(1);
+        }
+    }
+    return 0;
 }
 
+//==============================================================================
+//                              Semaphore API
+//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_thread_unregister_exit_callback
+ * @brief Default (weak) implementation of dmosi_semaphore_create
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param thread Thread handle the callback was registered on (unused)
- * @param handle Handle returned by dmosi_thread_register_exit_callback (unused)
- * @return int Always -ENOSYS
+ * @param initial_count Initial count for the semaphore (unused)
+ * @param max_count Maximum count for the semaphore (unused)
+ * @return dmosi_semaphore_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_unregister_exit_callback, (dmosi_thread_t thread, dmosi_thread_exit_callback_handle_t handle) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_semaphore_t, _semaphore_create,  (uint32_t initial_count, uint32_t max_count) )
 {
-    (void)thread;
-    (void)handle;
-    return -ENOSYS;
+    (void)initial_count;
+    (void)max_count;
+    return NULL;
 }
 
-//==============================================================================
-//                              Process API
-//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_process_create
+ * @brief Default (weak) implementation of dmosi_semaphore_create_static
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param name Name of the process (unused)
- * @param module_name Module name to associate with the process (unused)
- * @param parent Parent process (unused)
- * @return dmosi_process_t Always NULL
+ * @param initial_count Initial count for the semaphore (unused)
+ * @param max_count Maximum count for the semaphore (unused)
+ * @param storage Control block storage (unused)
+ * @return dmosi_semaphore_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_create,    (const char* name, const char* module_name, dmosi_process_t parent) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_semaphore_t, _semaphore_create_static, (uint32_t initial_count, uint32_t max_count, dmosi_semaphore_storage_t* storage) )
 {
-    (void)name;
-    (void)module_name;
-    (void)parent;
+    (void)initial_count;
+    (void)max_count;
+    (void)storage;
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_destroy
+ * @brief Default (weak) implementation of dmosi_semaphore_destroy
  *
  * Overridden by the platform-specific dmosi backend. This default is a no-op,
  * used when no backend has been linked in.
  *
- * @param process Process handle to destroy (unused)
+ * @param semaphore Semaphore handle to destroy (unused)
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _process_destroy,   (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _semaphore_destroy, (dmosi_semaphore_t semaphore) )
 {
-    (void)process;
+    (void)semaphore;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_kill
+ * @brief Default (weak) implementation of dmosi_semaphore_wait
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle to kill (unused)
- * @param status Exit status code (unused)
+ * @param semaphore Semaphore handle (unused)
+ * @param count Number of semaphore units to take (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_kill,      (dmosi_process_t process, int status) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 2.0, int, _semaphore_wait,    (dmosi_semaphore_t semaphore, uint32_t count, int32_t timeout_ms) )
 {
-    (void)process;
-    (void)status;
+    (void)semaphore;
+    (void)count;
+    (void)timeout_ms;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_wait
+ * @brief Default (weak) implementation of dmosi_semaphore_post
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle to wait for (unused)
- * @param timeout_ms Timeout in milliseconds (unused)
+ * @param semaphore Semaphore handle (unused)
+ * @param count Number of semaphore units to release (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_wait,      (dmosi_process_t process, int32_t timeout_ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 2.0, int, _semaphore_post,    (dmosi_semaphore_t semaphore, uint32_t count) )
 {
-    (void)process;
-    (void)timeout_ms;
+    (void)semaphore;
+    (void)count;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_current
+ * @brief Default (weak) implementation of dmosi_semaphore_post_from_isr
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @return dmosi_process_t Always NULL
+ * @param semaphore Semaphore handle (unused)
+ * @param count Number of semaphore units to release (unused)
+ * @param higher_priority_woken Left untouched
+ * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_current,   (void) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _semaphore_post_from_isr, (dmosi_semaphore_t semaphore, uint32_t count, bool* higher_priority_woken) )
 {
-    return NULL;
+    (void)semaphore;
+    (void)count;
+    (void)higher_priority_woken;
+    return -ENOSYS;
 }
 
+//==============================================================================
+//                              Address Wait API
+//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_process_set_current
+ * @brief Default (weak) implementation of dmosi_wait_on_address
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle to set as current (unused)
+ * @param address Address of the word to wait on (unused)
+ * @param expected Value the word is expected to hold (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_current, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _wait_on_address, (const volatile uint32_t* address, uint32_t expected, int32_t timeout_ms) )
 {
-    (void)process;
+    (void)address;
+    (void)expected;
+    (void)timeout_ms;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_state
+ * @brief Default (weak) implementation of dmosi_wake_address
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return dmosi_process_state_t Always DMOSI_PROCESS_STATE_TERMINATED
+ * @param address Address of the word threads are waiting on (unused)
+ * @param count Maximum number of threads to wake (unused)
+ * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_state_t, _process_get_state, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _wake_address,    (const volatile uint32_t* address, uint32_t count) )
 {
-    (void)process;
-    return DMOSI_PROCESS_STATE_TERMINATED;
+    (void)address;
+    (void)count;
+    return -ENOSYS;
 }
 
+//==============================================================================
+//                              Event Group API
+//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_process_get_id
+ * @brief Default (weak) implementation of dmosi_event_group_create
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return dmosi_process_id_t Always 0
+ * @return dmosi_event_group_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_id_t, _process_get_id, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_event_group_t, _event_group_create, (void) )
 {
-    (void)process;
-    return 0;
+    return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_id
+ * @brief Default (weak) implementation of dmosi_event_group_create_static
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param pid Process ID to set (unused)
- * @return int Always -ENOSYS
+ * @param storage Control block storage (unused)
+ * @return dmosi_event_group_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_id,    (dmosi_process_t process, dmosi_process_id_t pid) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_event_group_t, _event_group_create_static, (dmosi_event_group_storage_t* storage) )
 {
-    (void)process;
-    (void)pid;
-    return -ENOSYS;
+    (void)storage;
+    return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_name
+ * @brief Default (weak) implementation of dmosi_event_group_destroy
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return const char* Always NULL
+ * @param group Event group handle to destroy (unused)
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_name,  (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _event_group_destroy, (dmosi_event_group_t group) )
 {
-    (void)process;
-    return NULL;
+    (void)group;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_module_name
+ * @brief Default (weak) implementation of dmosi_event_group_set
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return const char* Always NULL
+ * @param group Event group handle (unused)
+ * @param bits Bits to set (unused)
+ * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_module_name, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _event_group_set, (dmosi_event_group_t group, uint32_t bits) )
 {
-    (void)process;
-    return NULL;
+    (void)group;
+    (void)bits;
+    return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_module_name
+ * @brief Default (weak) implementation of dmosi_event_group_set_from_isr
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param module_name Module name to associate with the process (unused)
+ * @param group Event group handle (unused)
+ * @param bits Bits to set (unused)
+ * @param higher_priority_woken Higher-priority wakeup flag (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_module_name, (dmosi_process_t process, const char* module_name) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _event_group_set_from_isr, (dmosi_event_group_t group, uint32_t bits, bool* higher_priority_woken) )
 {
-    (void)process;
-    (void)module_name;
+    (void)group;
+    (void)bits;
+    (void)higher_priority_woken;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_context
+ * @brief Default (weak) implementation of dmosi_event_group_clear
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param context Dmod_Context_t the process is running (unused)
+ * @param group Event group handle (unused)
+ * @param bits Bits to clear (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_context, (dmosi_process_t process, Dmod_Context_t* context) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _event_group_clear, (dmosi_event_group_t group, uint32_t bits) )
 {
-    (void)process;
-    (void)context;
+    (void)group;
+    (void)bits;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_context
+ * @brief Default (weak) implementation of dmosi_event_group_get
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return Dmod_Context_t* Always NULL
+ * @param group Event group handle (unused)
+ * @return uint32_t Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, Dmod_Context_t*, _process_get_context, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _event_group_get, (dmosi_event_group_t group) )
 {
-    (void)process;
-    return NULL;
+    (void)group;
+    return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_foreground_module
+ * @brief Default (weak) implementation of dmosi_event_group_wait
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param context Context to mark as the foreground module (unused)
+ * @param group Event group handle (unused)
+ * @param bits Bits to wait for (unused)
+ * @param flags Wait flags (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @param bits_out Bits output (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_foreground_module, (dmosi_process_t process, Dmod_Context_t* context) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _event_group_wait, (dmosi_event_group_t group, uint32_t bits, uint32_t flags, int32_t timeout_ms, uint32_t* bits_out) )
 {
-    (void)process;
-    (void)context;
+    (void)group;
+    (void)bits;
+    (void)flags;
+    (void)timeout_ms;
+    (void)bits_out;
     return -ENOSYS;
 }
 
+//==============================================================================
+//                              Thread API
+//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_process_get_foreground_module
+ * @brief Default (weak) implementation of dmosi_thread_create
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return Dmod_Context_t* Always NULL
+ * @param entry Entry function for the thread (unused)
+ * @param arg Argument to pass to the entry function (unused)
+ * @param priority Thread priority (unused)
+ * @param stack_size Stack size for the thread (unused)
+ * @param name Name of the thread (unused)
+ * @param process Process to associate the thread with (unused)
+ * @return dmosi_thread_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, Dmod_Context_t*, _process_get_foreground_module, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_t, _thread_create,    (dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process) )
 {
+    (void)entry;
+    (void)arg;
+    (void)priority;
+    (void)stack_size;
+    (void)name;
     (void)process;
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_uid
+ * @brief Default (weak) implementation of dmosi_thread_create_static
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param uid User ID to set (unused)
- * @return int Always -ENOSYS
+ * @param entry Entry function for the thread (unused)
+ * @param arg Argument to pass to the entry function (unused)
+ * @param priority Thread priority (unused)
+ * @param stack_size Stack size for the thread (unused)
+ * @param name Name of the thread (unused)
+ * @param process Process to associate the thread with (unused)
+ * @param storage Control block storage (unused)
+ * @param stack Stack memory (unused)
+ * @return dmosi_thread_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_uid,   (dmosi_process_t process, dmosi_user_id_t uid) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_t, _thread_create_static, (dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process, dmosi_thread_storage_t* storage, void* stack) )
 {
-    (void)process;
-    (void)uid;
-    return -ENOSYS;
+    (void)entry;
+    (void)arg;
+    (void)priority;
+    (void)stack_size;
+    (void)name;
+    (void)process;
+    (void)storage;
+    (void)stack;
+    return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_uid
+ * @brief Default (weak) implementation of dmosi_thread_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param thread Thread handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _thread_destroy,   (dmosi_thread_t thread) )
+{
+    (void)thread;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_thread_join
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return dmosi_user_id_t Always 0
+ * @param thread Thread handle to join (unused)
+ * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_user_id_t, _process_get_uid,   (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_join,      (dmosi_thread_t thread) )
 {
-    (void)process;
-    return 0;
+    (void)thread;
+    return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_pwd
+ * @brief Default (weak) implementation of dmosi_thread_kill
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param pwd Working directory path (unused)
+ * @param thread Thread handle to kill (unused)
+ * @param status Exit status code (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_pwd,   (dmosi_process_t process, const char* pwd) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_kill,      (dmosi_thread_t thread, int status) )
 {
-    (void)process;
-    (void)pwd;
+    (void)thread;
+    (void)status;
     return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_pwd
+ * @brief Default (weak) implementation of dmosi_thread_current
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return const char* Always NULL
+ * @return dmosi_thread_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_pwd,   (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_t, _thread_current,   (void) )
 {
-    (void)process;
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_stream
+ * @brief Default (weak) implementation of dmosi_thread_sleep
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param index Stream slot to set (unused)
- * @param path Path to bind to the stream slot (unused)
- * @return int Always -ENOSYS
+ * @param ms Time to sleep in milliseconds (unused)
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_stream,   (dmosi_process_t process, dmosi_stream_index_t index, const char* path) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _thread_sleep,     (uint32_t ms) )
 {
-    (void)process;
-    (void)index;
-    (void)path;
-    return -ENOSYS;
+    (void)ms;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_stream
+ * @brief Generic implementation of dmosi_thread_sleep_until
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Sleeps with dmosi_thread_sleep for the ticks left until the deadline,
+ * assuming one tick per millisecond, and repeats if woken early. Overridden
+ * by backends with an absolute wait of their own.
  *
- * @param process Process handle (unused)
- * @param index Stream slot to query (unused)
- * @return void* Always NULL
+ * @param next_wake_tick Tick count to wake at, advanced by @p period on return
+ * @param period Period in ticks
+ * @return int 0 on success, -ETIMEDOUT if the deadline had already passed,
+ *         -EINVAL if @p next_wake_tick is NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void*, _process_get_stream,   (dmosi_process_t process, dmosi_stream_index_t index) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_sleep_until, (uint32_t* next_wake_tick, uint32_t period) )
 {
-    (void)process;
-    (void)index;
-    return NULL;
+    if (next_wake_tick == NULL) {
+        return -EINVAL;
+    }
+
+    int result = 0;
+    int32_t remaining = (int32_t)(*next_wake_tick - dmosi_get_tick_count());
+    if (remaining < 0) {
+        result = -ETIMEDOUT;
+    }
+    while (remaining > 0) {
+        dmosi_thread_sleep((uint32_t)remaining);
+        remaining = (int32_t)(*next_wake_tick - dmosi_get_tick_count());
+    }
+
+    *next_wake_tick += period;
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_stream_path
+ * @brief Generic implementation of dmosi_thread_sleep_us
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Rounds up to whole milliseconds for dmosi_thread_sleep. Overridden by
+ * backends with a high-resolution timer.
  *
- * @param process Process handle (unused)
- * @param index Stream slot to query (unused)
- * @return const char* Always NULL
+ * @param us Time to sleep in microseconds
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_stream_path, (dmosi_process_t process, dmosi_stream_index_t index) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _thread_sleep_us,  (uint32_t us) )
 {
-    (void)process;
-    (void)index;
-    return NULL;
+    uint32_t ms = us / 1000u + ((us % 1000u) != 0u ? 1u : 0u);
+    if (ms > 0) {
+        dmosi_thread_sleep(ms);
+    }
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_lock_stream
+ * @brief Default (weak) implementation of dmosi_thread_get_name
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param index Stream slot to lock (unused)
- * @return int Always -ENOSYS
+ * @param thread Thread handle (unused)
+ * @return const char* Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_lock_stream,  (dmosi_process_t process, dmosi_stream_index_t index) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _thread_get_name,  (dmosi_thread_t thread) )
 {
-    (void)process;
-    (void)index;
-    return -ENOSYS;
+    (void)thread;
+    return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_unlock_stream
+ * @brief Default (weak) implementation of dmosi_thread_get_module_name
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param index Stream slot to unlock (unused)
- * @return int Always -ENOSYS
+ * @param thread Thread handle (unused)
+ * @return const char* Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_unlock_stream, (dmosi_process_t process, dmosi_stream_index_t index) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _thread_get_module_name,  (dmosi_thread_t thread) )
 {
-    (void)process;
-    (void)index;
-    return -ENOSYS;
+    (void)thread;
+    return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_find_by_name
+ * @brief Default (weak) implementation of dmosi_thread_get_priority
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param name Process name to search for (unused)
- * @return dmosi_process_t Always NULL
+ * @param thread Thread handle (unused)
+ * @return int Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_find_by_name, (const char* name) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_get_priority,  (dmosi_thread_t thread) )
 {
-    (void)name;
-    return NULL;
+    (void)thread;
+    return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_find_by_id
+ * @brief Default (weak) implementation of dmosi_thread_get_process
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param pid Process ID to search for (unused)
+ * @param thread Thread handle (unused)
  * @return dmosi_process_t Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_find_by_id,   (dmosi_process_id_t pid) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _thread_get_process, (dmosi_thread_t thread) )
 {
-    (void)pid;
+    (void)thread;
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_exit_status
+ * @brief Default (weak) implementation of dmosi_thread_get_all
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @return int Always 0
+ * @param threads Pointer to array to fill with thread handles (unused)
+ * @param max_count Maximum number of handles to write (unused)
+ * @return size_t Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_get_exit_status, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _thread_get_all, (dmosi_thread_t* threads, size_t max_count) )
 {
-    (void)process;
+    (void)threads;
+    (void)max_count;
     return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_set_exit_status
+ * @brief Default (weak) implementation of dmosi_thread_get_by_process
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle (unused)
- * @param exit_status Exit status to set (unused)
- * @return int Always -ENOSYS
+ * @param process Process handle whose threads to retrieve (unused)
+ * @param threads Pointer to array to fill with thread handles (unused)
+ * @param max_count Maximum number of handles to write (unused)
+ * @return size_t Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_exit_status, (dmosi_process_t process, int exit_status) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _thread_get_by_process, (dmosi_process_t process, dmosi_thread_t* threads, size_t max_count) )
 {
     (void)process;
-    (void)exit_status;
-    return -ENOSYS;
+    (void)threads;
+    (void)max_count;
+    return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_get_parent
+ * @brief Default (weak) implementation of dmosi_thread_get_info
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Overridden by the platform-specific dmosi backend. This default fills @p info
+ * with zeroed/terminated values and reports failure, used when no backend has
+ * been linked in.
  *
- * @param process Process handle (unused)
- * @return dmosi_process_t Always NULL
+ * @param thread Thread handle (unused)
+ * @param info Pointer to a dmosi_thread_info_t structure to fill
+ * @return int -EINVAL if @p info is NULL, otherwise -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_get_parent, (dmosi_process_t process) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_get_info, (dmosi_thread_t thread, dmosi_thread_info_t* info) )
 {
-    (void)process;
-    return NULL;
+    (void)thread;
+    if (info == NULL) {
+        return -EINVAL;
+    }
+    info->stack_total   = 0;
+    info->stack_current = 0;
+    info->stack_peak    = 0;
+    info->state         = DMOSI_THREAD_STATE_TERMINATED;
+    info->cpu_usage     = 0.0f;
+    info->runtime_ms    = 0;
+    return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_register_exit_callback
+ * @brief Default (weak) implementation of dmosi_thread_set_affinity
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle to observe (unused)
- * @param callback Callback function to invoke on process exit (unused)
- * @param arg User-provided argument passed to the callback (unused)
- * @return dmosi_process_exit_callback_handle_t Always NULL
+ * @param thread Thread handle (unused)
+ * @param mask Cores the thread may run on (unused)
+ * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_exit_callback_handle_t, _process_register_exit_callback,   (dmosi_process_t process, dmosi_process_exit_callback_t callback, void* arg) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_set_affinity, (dmosi_thread_t thread, dmosi_cpu_mask_t mask) )
 {
-    (void)process;
-    (void)callback;
-    (void)arg;
-    return NULL;
+    (void)thread;
+    (void)mask;
+    return -ENOSYS;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_process_unregister_exit_callback
+ * @brief Default (weak) implementation of dmosi_thread_get_affinity
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param process Process handle the callback was registered on (unused)
- * @param handle Handle returned by dmosi_process_register_exit_callback (unused)
+ * @param thread Thread handle (unused)
+ * @param mask Filled with the cores the thread may run on (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_unregister_exit_callback, (dmosi_process_t process, dmosi_process_exit_callback_handle_t handle) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_get_affinity, (dmosi_thread_t thread, dmosi_cpu_mask_t* mask) )
 {
-    (void)process;
-    (void)handle;
+    (void)thread;
+    (void)mask;
     return -ENOSYS;
 }
 
-//==============================================================================
-//                              Queue API
-//==============================================================================
 /**
- * @brief Default (weak) implementation of dmosi_queue_create
+ * @brief Default (weak) implementation of dmosi_get_core_count
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Overridden by the platform-specific dmosi backend. This default reports a
+ * single core, used when no backend has been linked in.
  *
- * @param item_size Size of each item in the queue (unused)
- * @param queue_length Maximum number of items in the queue (unused)
- * @return dmosi_queue_t Always NULL
+ * @return uint32_t Always 1
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_queue_t, _queue_create,  (size_t item_size, uint32_t queue_length) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _get_core_count, (void) )
 {
-    (void)item_size;
-    (void)queue_length;
-    return NULL;
+    return 1;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_queue_destroy
+ * @brief Default (weak) implementation of dmosi_get_current_core
  *
- * Overridden by the platform-specific dmosi backend. This default is a no-op,
- * used when no backend has been linked in.
+ * Overridden by the platform-specific dmosi backend. This default reports
+ * core 0, used when no backend has been linked in.
  *
- * @param queue Queue handle to destroy (unused)
+ * @return uint32_t Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _queue_destroy, (dmosi_queue_t queue) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _get_current_core, (void) )
 {
-    (void)queue;
+    return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_queue_send
+ * @brief Default (weak) implementation of dmosi_thread_get_last_core
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * Overridden by the platform-specific dmosi backend. This default reports
+ * core 0, used when no backend has been linked in.
  *
- * @param queue Queue handle (unused)
- * @param item Pointer to the item to send (unused)
- * @param timeout_ms Timeout in milliseconds (unused)
- * @return int Always -ENOSYS
+ * @param thread Thread handle (unused)
+ * @return uint32_t Always 0
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_send,    (dmosi_queue_t queue, const void* item, int32_t timeout_ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _thread_get_last_core, (dmosi_thread_t thread) )
 {
-    (void)queue;
-    (void)item;
-    (void)timeout_ms;
-    return -ENOSYS;
+    (void)thread;
+    return 0;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_queue_receive
+ * @brief Default (weak) implementation of dmosi_thread_register_exit_callback
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param queue Queue handle (unused)
- * @param item Pointer to buffer to receive the item (unused)
- * @param timeout_ms Timeout in milliseconds (unused)
+ * @param thread Thread handle to observe (unused)
+ * @param callback Callback function to invoke on thread exit (unused)
+ * @param arg User-provided argument passed to the callback (unused)
+ * @return dmosi_thread_exit_callback_handle_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_thread_exit_callback_handle_t, _thread_register_exit_callback,   (dmosi_thread_t thread, dmosi_thread_exit_callback_t callback, void* arg) )
+{
+    (void)thread;
+    (void)callback;
+    (void)arg;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_thread_unregister_exit_callback
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param thread Thread handle the callback was registered on (unused)
+ * @param handle Handle returned by dmosi_thread_register_exit_callback (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_receive, (dmosi_queue_t queue, void* item, int32_t timeout_ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _thread_unregister_exit_callback, (dmosi_thread_t thread, dmosi_thread_exit_callback_handle_t handle) )
 {
-    (void)queue;
-    (void)item;
-    (void)timeout_ms;
+    (void)thread;
+    (void)handle;
     return -ENOSYS;
 }
 
 //==============================================================================
-//                              Timer API
+//                              Thread-Local Storage API
 //==============================================================================
+/*
+ * A key is a slot index tagged with a generation, bumped every time the slot
+ * is handed out, so a key that was deleted can never be mistaken for the key
+ * that later reuses its slot. Slot 0 points to the thread's record of which
+ * key wrote each of its slots, allocated the first time the thread stores a
+ * non-NULL value, together with the exit callback that runs the destructors
+ * and frees it. A value is only visible through the key that wrote it:
+ * values left by a deleted key are ignored rather than swept out of other
+ * threads, so only the owning thread ever writes its slots. Slot 1 caches
+ * the thread's current process for dmosi_process_current_cached. The key
+ * registry is protected by a spinlock, since creating and deleting keys is
+ * rare and quick; the key currently live in each slot can also be read
+ * without it.
+ */
+
+#if DMOSI_TLS_SLOT_COUNT > 32 || DMOSI_TLS_SLOT_COUNT <= DMOSI_TLS_RESERVED_SLOTS
+#   error "DMOSI_TLS_SLOT_COUNT must be greater than DMOSI_TLS_RESERVED_SLOTS and at most 32"
+#endif
+
 /**
- * @brief Default (weak) implementation of dmosi_timer_create
+ * @brief Reserved slot pointing to the thread's dmosi_tls_thread_t
+ */
+#define DMOSI_TLS_SLOT_THREAD           0
+
+/**
+ * @brief Reserved slot caching the thread's current process
+ */
+#define DMOSI_TLS_SLOT_PROCESS          1
+
+/**
+ * @brief Rounds of destructor calls on thread exit, for destructors that set values again
+ */
+#define DMOSI_TLS_DESTRUCTOR_ROUNDS     4
+
+/**
+ * @brief Bits of a key holding the slot index, the rest holds the generation
+ */
+#define DMOSI_TLS_KEY_INDEX_BITS        8
+#define DMOSI_TLS_KEY_INDEX_MASK        ((1u << DMOSI_TLS_KEY_INDEX_BITS) - 1u)
+#define DMOSI_TLS_KEY_GENERATION_MAX    (UINT32_MAX >> DMOSI_TLS_KEY_INDEX_BITS)
+
+/**
+ * @brief Per-thread record of the thread-local storage, in DMOSI_TLS_SLOT_THREAD
+ */
+typedef struct {
+    dmosi_thread_exit_callback_handle_t exit_callback;              //!< Callback running the destructors
+    dmosi_tls_key_t                     keys[DMOSI_TLS_SLOT_COUNT]; //!< Key that wrote each slot, 0 if none
+} dmosi_tls_thread_t;
+
+static dmosi_spinlock_t        s_tls_lock = DMOSI_SPINLOCK_INIT;    //!< Protects the key registry
+static uint32_t                s_tls_keys[DMOSI_TLS_SLOT_COUNT];    //!< Key live in each slot, 0 if free (atomic)
+static uint32_t                s_tls_generations[DMOSI_TLS_SLOT_COUNT]; //!< Generation last handed out for each slot
+static dmosi_tls_destructor_t  s_tls_destructors[DMOSI_TLS_SLOT_COUNT];
+
+/**
+ * @brief Slot index of a key, DMOSI_TLS_SLOT_COUNT if the key is malformed
+ */
+static uint32_t dmosi_tls_key_index(dmosi_tls_key_t key)
+{
+    uint32_t index = key & DMOSI_TLS_KEY_INDEX_MASK;
+    return (index >= DMOSI_TLS_RESERVED_SLOTS && index < DMOSI_TLS_SLOT_COUNT) ? index : DMOSI_TLS_SLOT_COUNT;
+}
+
+/**
+ * @brief Whether @p key has been created and not deleted since
+ */
+static bool dmosi_tls_key_live(dmosi_tls_key_t key)
+{
+    uint32_t index = dmosi_tls_key_index(key);
+    return index < DMOSI_TLS_SLOT_COUNT
+        && dmosi_atomic_load_u32(&s_tls_keys[index], DMOSI_MEMORY_ORDER_ACQUIRE) == key;
+}
+
+/**
+ * @brief Get the destructor of a key, NULL if none or the key has been deleted
+ */
+static dmosi_tls_destructor_t dmosi_tls_get_destructor(dmosi_tls_key_t key)
+{
+    uint32_t index = dmosi_tls_key_index(key);
+    if (index >= DMOSI_TLS_SLOT_COUNT) {
+        return NULL;
+    }
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_tls_lock);
+    dmosi_tls_destructor_t destructor = (s_tls_keys[index] == key) ? s_tls_destructors[index] : NULL;
+    dmosi_spinlock_unlock(&s_tls_lock, state);
+    return destructor;
+}
+
+/**
+ * @brief Thread exit callback running the destructors of the thread's values
+ *
+ * @param thread Exiting thread
+ * @param arg The thread's dmosi_tls_thread_t, freed on return
+ */
+static void dmosi_tls_thread_exit(dmosi_thread_t thread, void* arg)
+{
+    dmosi_tls_thread_t* record = arg;
+    void** slots = dmosi_thread_get_tls_slots(thread);
+    if (slots != NULL) {
+        for (uint32_t round = 0; round < DMOSI_TLS_DESTRUCTOR_ROUNDS; round++) {
+            bool called = false;
+            for (uint32_t index = DMOSI_TLS_RESERVED_SLOTS; index < DMOSI_TLS_SLOT_COUNT; index++) {
+                void* value = slots[index];
+                if (value == NULL) {
+                    continue;
+                }
+                slots[index] = NULL;
+                // Values left by a deleted key are dropped without a destructor
+                dmosi_tls_destructor_t destructor = dmosi_tls_get_destructor(record->keys[index]);
+                if (destructor != NULL) {
+                    destructor(value);
+                    called = true;
+                }
+            }
+            if (!called) {
+                break;
+            }
+        }
+        dmosi_atomic_store_ptr(&slots[DMOSI_TLS_SLOT_PROCESS], NULL, DMOSI_MEMORY_ORDER_RELAXED);
+        slots[DMOSI_TLS_SLOT_THREAD]  = NULL;
+    }
+    Dmod_Free(record);
+}
+
+#if !defined(DMOSI_DONT_IMPLEMENT_DMOD_API) && !defined(DMOSI_DONT_IMPLEMENT_DMOD_API_PROC)
+/**
+ * @brief Run the destructors of the calling thread's values and drop them, as on thread exit
+ *
+ * Lets a spawned module's thread destroy the module's values while the
+ * module - and so its destructors - is still loaded, and a spawn pool worker
+ * start the next module with empty thread-local storage. If the exit
+ * callback can't be unregistered the values are left alone, to be destroyed
+ * when the thread really exits.
+ */
+static void dmosi_tls_thread_reset(void)
+{
+    void** slots = dmosi_thread_get_tls_slots(NULL);
+    if (slots == NULL) {
+        return;
+    }
+    dmosi_tls_thread_t* record = slots[DMOSI_TLS_SLOT_THREAD];
+    if (record != NULL && dmosi_thread_unregister_exit_callback(dmosi_thread_current(), record->exit_callback) == 0) {
+        dmosi_tls_thread_exit(dmosi_thread_current(), record);
+    }
+}
+#endif // !DMOSI_DONT_IMPLEMENT_DMOD_API && !DMOSI_DONT_IMPLEMENT_DMOD_API_PROC
+
+/**
+ * @brief Default (weak) implementation of dmosi_thread_get_tls_slots
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param callback Callback function to execute when timer expires (unused)
- * @param arg Argument to pass to the callback function (unused)
- * @param period_ms Timer period in milliseconds (unused)
- * @param auto_reload Whether the timer should auto-reload (unused)
- * @return dmosi_timer_t Always NULL
+ * @param thread Thread handle (unused)
+ * @return void** Always NULL
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_timer_t, _timer_create,  (dmosi_timer_callback_t callback, void* arg, uint32_t period_ms, bool auto_reload) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void**, _thread_get_tls_slots, (dmosi_thread_t thread) )
 {
-    (void)callback;
-    (void)arg;
-    (void)period_ms;
-    (void)auto_reload;
+    (void)thread;
     return NULL;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_timer_destroy
+ * @brief Generic implementation of dmosi_tls_key_create
+ *
+ * @param key Filled with the new key
+ * @param destructor Destructor of the key's values (may be NULL)
+ * @return int 0 on success, -EAGAIN if every slot is in use, other negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _tls_key_create, (dmosi_tls_key_t* key, dmosi_tls_destructor_t destructor) )
+{
+    if (key == NULL) {
+        return -EINVAL;
+    }
+
+    int result = -EAGAIN;
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_tls_lock);
+    for (uint32_t index = DMOSI_TLS_RESERVED_SLOTS; index < DMOSI_TLS_SLOT_COUNT; index++) {
+        if (s_tls_keys[index] == 0) {
+            // Generation 0 is never used, so no key is ever 0
+            uint32_t generation = (s_tls_generations[index] < DMOSI_TLS_KEY_GENERATION_MAX) ? s_tls_generations[index] + 1 : 1;
+            s_tls_generations[index] = generation;
+            s_tls_destructors[index] = destructor;
+            *key = (generation << DMOSI_TLS_KEY_INDEX_BITS) | index;
+            dmosi_atomic_store_u32(&s_tls_keys[index], *key, DMOSI_MEMORY_ORDER_RELEASE);
+            result = 0;
+            break;
+        }
+    }
+    dmosi_spinlock_unlock(&s_tls_lock, state);
+    return result;
+}
+
+/**
+ * @brief Generic implementation of dmosi_tls_key_delete
+ *
+ * Only unregisters the key: values threads still hold for it are left in
+ * their slots, where the key that next takes the slot ignores them.
+ *
+ * @param key Key to delete
+ * @return int 0 on success, negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _tls_key_delete, (dmosi_tls_key_t key) )
+{
+    uint32_t index = dmosi_tls_key_index(key);
+    if (index >= DMOSI_TLS_SLOT_COUNT) {
+        return -EINVAL;
+    }
+
+    int result = -EINVAL;
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_tls_lock);
+    if (s_tls_keys[index] == key) {
+        dmosi_atomic_store_u32(&s_tls_keys[index], 0, DMOSI_MEMORY_ORDER_RELEASE);
+        s_tls_destructors[index] = NULL;
+        result = 0;
+    }
+    dmosi_spinlock_unlock(&s_tls_lock, state);
+    return result;
+}
+
+/**
+ * @brief Generic implementation of dmosi_tls_set
+ *
+ * @param key Key created with dmosi_tls_key_create
+ * @param value New value
+ * @return int 0 on success, -EINVAL if @p key is not a live key, other negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _tls_set, (dmosi_tls_key_t key, void* value) )
+{
+    if (!dmosi_tls_key_live(key)) {
+        return -EINVAL;
+    }
+    void** slots = dmosi_thread_get_tls_slots(NULL);
+    if (slots == NULL) {
+        return -ENOSYS;
+    }
+
+    dmosi_tls_thread_t* record = slots[DMOSI_TLS_SLOT_THREAD];
+    if (record == NULL) {
+        if (value == NULL) {
+            // Nothing stored yet, so every key already reads NULL
+            return 0;
+        }
+        record = Dmod_Malloc(sizeof(dmosi_tls_thread_t));
+        if (record == NULL) {
+            return -ENOMEM;
+        }
+        memset(record, 0, sizeof(dmosi_tls_thread_t));
+        record->exit_callback = dmosi_thread_register_exit_callback(dmosi_thread_current(), dmosi_tls_thread_exit, record);
+        if (record->exit_callback == NULL) {
+            Dmod_Free(record);
+            return -ENOMEM;
+        }
+        slots[DMOSI_TLS_SLOT_THREAD] = record;
+    }
+
+    uint32_t index = dmosi_tls_key_index(key);
+    record->keys[index] = key;
+    slots[index]        = value;
+    return 0;
+}
+
+/**
+ * @brief Generic implementation of dmosi_tls_get
+ *
+ * @param key Key created with dmosi_tls_key_create
+ * @return void* Value of the key, NULL if never set or on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void*, _tls_get, (dmosi_tls_key_t key) )
+{
+    if (!dmosi_tls_key_live(key)) {
+        return NULL;
+    }
+    void** slots = dmosi_thread_get_tls_slots(NULL);
+    if (slots == NULL) {
+        return NULL;
+    }
+    dmosi_tls_thread_t* record = slots[DMOSI_TLS_SLOT_THREAD];
+    uint32_t index = dmosi_tls_key_index(key);
+    return (record != NULL && record->keys[index] == key) ? slots[index] : NULL;
+}
+
+//==============================================================================
+//                              Process API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_process_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param name Name of the process (unused)
+ * @param module_name Module name to associate with the process (unused)
+ * @param parent Parent process (unused)
+ * @return dmosi_process_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_create,    (const char* name, const char* module_name, dmosi_process_t parent) )
+{
+    (void)name;
+    (void)module_name;
+    (void)parent;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_destroy
  *
  * Overridden by the platform-specific dmosi backend. This default is a no-op,
  * used when no backend has been linked in.
  *
- * @param timer Timer handle to destroy (unused)
+ * @param process Process handle to destroy (unused)
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _timer_destroy, (dmosi_timer_t timer) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _process_destroy,   (dmosi_process_t process) )
 {
-    (void)timer;
+    (void)process;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_timer_start
+ * @brief Default (weak) implementation of dmosi_process_kill
  *
  * Overridden by the platform-specific dmosi backend. This default is used
  * when no backend has been linked in.
  *
- * @param timer Timer handle to start (unused)
+ * @param process Process handle to kill (unused)
+ * @param status Exit status code (unused)
  * @return int Always -ENOSYS
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_start,   (dmosi_timer_t timer) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_kill,      (dmosi_process_t process, int status) )
 {
-    (void)timer;
+    (void)process;
+    (void)status;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_wait
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle to wait for (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_wait,      (dmosi_process_t process, int32_t timeout_ms) )
+{
+    (void)process;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_current
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @return dmosi_process_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_current,   (void) )
+{
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_current
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle to set as current (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_current, (dmosi_process_t process) )
+{
+    (void)process;
     return -ENOSYS;
 }
 
+#if defined(DMOSI_ENABLE_PROCESS_CACHE)
+/**
+ * @brief Marks a cache slot whose owner is looking the process up
+ *
+ * dmosi_process_invalidate_cached from another thread replaces it with NULL,
+ * which tells the owner its lookup may be stale and must not be cached.
+ */
+static char s_process_cache_filling;
+#define DMOSI_PROCESS_CACHE_FILLING     ((void*)&s_process_cache_filling)
+#endif
+
+/**
+ * @brief Generic implementation of dmosi_process_current_cached
+ *
+ * With DMOSI_ENABLE_PROCESS_CACHE, reads the process from the calling
+ * thread's DMOSI_TLS_SLOT_PROCESS slot, filling it with dmosi_process_current
+ * on a miss. A NULL process is not cached, so threads without a process keep
+ * asking the backend. The slot is accessed atomically, as
+ * dmosi_process_invalidate_cached may clear it from another thread.
+ *
+ * @return dmosi_process_t Current process handle, NULL if none
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_current_cached, (void) )
+{
+#if defined(DMOSI_ENABLE_PROCESS_CACHE)
+    void** slots = dmosi_thread_get_tls_slots(NULL);
+    if (slots == NULL) {
+        return dmosi_process_current();
+    }
+
+    void* cached = dmosi_atomic_load_ptr(&slots[DMOSI_TLS_SLOT_PROCESS], DMOSI_MEMORY_ORDER_ACQUIRE);
+    if (cached != NULL && cached != DMOSI_PROCESS_CACHE_FILLING) {
+        return (dmosi_process_t)cached;
+    }
+
+    // Only this thread fills its slot; an invalidation landing during the
+    // lookup replaces the marker, and the compare-exchange then keeps the
+    // (possibly stale) result out of the cache
+    dmosi_atomic_store_ptr(&slots[DMOSI_TLS_SLOT_PROCESS], DMOSI_PROCESS_CACHE_FILLING, DMOSI_MEMORY_ORDER_SEQ_CST);
+    dmosi_process_t process = dmosi_process_current();
+    void* expected = DMOSI_PROCESS_CACHE_FILLING;
+    dmosi_atomic_compare_exchange_ptr(&slots[DMOSI_TLS_SLOT_PROCESS], &expected, process,
+                                      DMOSI_MEMORY_ORDER_RELEASE, DMOSI_MEMORY_ORDER_RELAXED);
+    return process;
+#else
+    return dmosi_process_current();
+#endif
+}
+
+/**
+ * @brief Generic implementation of dmosi_process_invalidate_cached
+ *
+ * @param thread Thread whose cache to clear (NULL for the calling thread)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _process_invalidate_cached, (dmosi_thread_t thread) )
+{
+    void** slots = dmosi_thread_get_tls_slots(thread);
+    if (slots != NULL) {
+        dmosi_atomic_store_ptr(&slots[DMOSI_TLS_SLOT_PROCESS], NULL, DMOSI_MEMORY_ORDER_RELAXED);
+    }
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_state
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return dmosi_process_state_t Always DMOSI_PROCESS_STATE_TERMINATED
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_state_t, _process_get_state, (dmosi_process_t process) )
+{
+    (void)process;
+    return DMOSI_PROCESS_STATE_TERMINATED;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_id
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return dmosi_process_id_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_id_t, _process_get_id, (dmosi_process_t process) )
+{
+    (void)process;
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_id
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param pid Process ID to set (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_id,    (dmosi_process_t process, dmosi_process_id_t pid) )
+{
+    (void)process;
+    (void)pid;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_name
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return const char* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_name,  (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_module_name
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return const char* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_module_name, (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_module_name
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param module_name Module name to associate with the process (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_module_name, (dmosi_process_t process, const char* module_name) )
+{
+    (void)process;
+    (void)module_name;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_context
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param context Dmod_Context_t the process is running (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_context, (dmosi_process_t process, Dmod_Context_t* context) )
+{
+    (void)process;
+    (void)context;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_context
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return Dmod_Context_t* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, Dmod_Context_t*, _process_get_context, (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_foreground_module
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param context Context to mark as the foreground module (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_foreground_module, (dmosi_process_t process, Dmod_Context_t* context) )
+{
+    (void)process;
+    (void)context;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_foreground_module
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return Dmod_Context_t* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, Dmod_Context_t*, _process_get_foreground_module, (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_uid
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param uid User ID to set (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_uid,   (dmosi_process_t process, dmosi_user_id_t uid) )
+{
+    (void)process;
+    (void)uid;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_uid
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return dmosi_user_id_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_user_id_t, _process_get_uid,   (dmosi_process_t process) )
+{
+    (void)process;
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_pwd
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param pwd Working directory path (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_pwd,   (dmosi_process_t process, const char* pwd) )
+{
+    (void)process;
+    (void)pwd;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_pwd
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return const char* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_pwd,   (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_stream
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param index Stream slot to set (unused)
+ * @param path Path to bind to the stream slot (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_stream,   (dmosi_process_t process, dmosi_stream_index_t index, const char* path) )
+{
+    (void)process;
+    (void)index;
+    (void)path;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_stream
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param index Stream slot to query (unused)
+ * @return void* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void*, _process_get_stream,   (dmosi_process_t process, dmosi_stream_index_t index) )
+{
+    (void)process;
+    (void)index;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_stream_path
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param index Stream slot to query (unused)
+ * @return const char* Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, const char*, _process_get_stream_path, (dmosi_process_t process, dmosi_stream_index_t index) )
+{
+    (void)process;
+    (void)index;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_lock_stream
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param index Stream slot to lock (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_lock_stream,  (dmosi_process_t process, dmosi_stream_index_t index) )
+{
+    (void)process;
+    (void)index;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_unlock_stream
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param index Stream slot to unlock (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_unlock_stream, (dmosi_process_t process, dmosi_stream_index_t index) )
+{
+    (void)process;
+    (void)index;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_find_by_name
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param name Process name to search for (unused)
+ * @return dmosi_process_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_find_by_name, (const char* name) )
+{
+    (void)name;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_find_by_id
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param pid Process ID to search for (unused)
+ * @return dmosi_process_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_find_by_id,   (dmosi_process_id_t pid) )
+{
+    (void)pid;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_exit_status
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return int Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_get_exit_status, (dmosi_process_t process) )
+{
+    (void)process;
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_set_exit_status
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @param exit_status Exit status to set (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_set_exit_status, (dmosi_process_t process, int exit_status) )
+{
+    (void)process;
+    (void)exit_status;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_get_parent
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle (unused)
+ * @return dmosi_process_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_t, _process_get_parent, (dmosi_process_t process) )
+{
+    (void)process;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_register_exit_callback
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle to observe (unused)
+ * @param callback Callback function to invoke on process exit (unused)
+ * @param arg User-provided argument passed to the callback (unused)
+ * @return dmosi_process_exit_callback_handle_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_process_exit_callback_handle_t, _process_register_exit_callback,   (dmosi_process_t process, dmosi_process_exit_callback_t callback, void* arg) )
+{
+    (void)process;
+    (void)callback;
+    (void)arg;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_process_unregister_exit_callback
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param process Process handle the callback was registered on (unused)
+ * @param handle Handle returned by dmosi_process_register_exit_callback (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _process_unregister_exit_callback, (dmosi_process_t process, dmosi_process_exit_callback_handle_t handle) )
+{
+    (void)process;
+    (void)handle;
+    return -ENOSYS;
+}
+
+#if !defined(DMOSI_ENABLE_SPAWN_POOL) || defined(DMOSI_DONT_IMPLEMENT_DMOD_API) || defined(DMOSI_DONT_IMPLEMENT_DMOD_API_PROC)
+/**
+ * @brief Default (weak) implementation of dmosi_spawn_pool_prewarm
+ *
+ * Used when dmosi is built without DMOSI_ENABLE_SPAWN_POOL; the pool is
+ * implemented next to Dmod_Spawn in the DMOD process API section.
+ *
+ * @param stack_size Module stack size the workers are sized for (unused)
+ * @param priority Priority of the workers (unused)
+ * @param count Number of workers to start (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _spawn_pool_prewarm, (size_t stack_size, int priority, size_t count) )
+{
+    (void)stack_size;
+    (void)priority;
+    (void)count;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_spawn_pool_trim
+ *
+ * Used when dmosi is built without DMOSI_ENABLE_SPAWN_POOL.
+ *
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _spawn_pool_trim, (void) )
+{
+    return -ENOSYS;
+}
+#endif
+
+//==============================================================================
+//                              Queue API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_queue_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param item_size Size of each item in the queue (unused)
+ * @param queue_length Maximum number of items in the queue (unused)
+ * @return dmosi_queue_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_queue_t, _queue_create,  (size_t item_size, uint32_t queue_length) )
+{
+    (void)item_size;
+    (void)queue_length;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_create_ex
+ *
+ * Overridden by the platform-specific dmosi backend. This default only handles
+ * the flag-less case, which it forwards to dmosi_queue_create; any other flag
+ * needs backend support.
+ *
+ * @param item_size Size of each item in the queue
+ * @param queue_length Maximum number of items in the queue
+ * @param flags Combination of dmosi_queue_flags_t values
+ * @return dmosi_queue_t Result of dmosi_queue_create if @p flags is 0, NULL otherwise
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_queue_t, _queue_create_ex, (size_t item_size, uint32_t queue_length, uint32_t flags) )
+{
+    if (flags != DMOSI_QUEUE_DEFAULT) {
+        return NULL;
+    }
+    return dmosi_queue_create(item_size, queue_length);
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_create_static
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param item_size Size of each item in the queue (unused)
+ * @param queue_length Maximum number of items in the queue (unused)
+ * @param storage Control block storage (unused)
+ * @param buffer Item buffer (unused)
+ * @return dmosi_queue_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_queue_t, _queue_create_static, (size_t item_size, uint32_t queue_length, dmosi_queue_storage_t* storage, void* buffer) )
+{
+    (void)item_size;
+    (void)queue_length;
+    (void)storage;
+    (void)buffer;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param queue Queue handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _queue_destroy, (dmosi_queue_t queue) )
+{
+    (void)queue;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_send
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param item Pointer to the item to send (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_send,    (dmosi_queue_t queue, const void* item, int32_t timeout_ms) )
+{
+    (void)queue;
+    (void)item;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_receive
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param item Pointer to buffer to receive the item (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_receive, (dmosi_queue_t queue, void* item, int32_t timeout_ms) )
+{
+    (void)queue;
+    (void)item;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_send_from_isr
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param item Pointer to the item to send (unused)
+ * @param higher_priority_woken Left untouched
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_send_from_isr,    (dmosi_queue_t queue, const void* item, bool* higher_priority_woken) )
+{
+    (void)queue;
+    (void)item;
+    (void)higher_priority_woken;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_receive_from_isr
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param item Pointer to buffer to receive the item (unused)
+ * @param higher_priority_woken Left untouched
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_receive_from_isr, (dmosi_queue_t queue, void* item, bool* higher_priority_woken) )
+{
+    (void)queue;
+    (void)item;
+    (void)higher_priority_woken;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_peek
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param item Pointer to buffer to receive the item (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_peek,    (dmosi_queue_t queue, void* item, int32_t timeout_ms) )
+{
+    (void)queue;
+    (void)item;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_get_item_size
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @return size_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _queue_get_item_size, (dmosi_queue_t queue) )
+{
+    (void)queue;
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_get_stats
+ *
+ * Overridden by the platform-specific dmosi backend. This default fills
+ * @p stats with zeroes and reports failure, used when no backend has been
+ * linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param stats Pointer to a dmosi_queue_stats_t structure to fill
+ * @return int -EINVAL if @p stats is NULL, otherwise -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_get_stats, (dmosi_queue_t queue, dmosi_queue_stats_t* stats) )
+{
+    (void)queue;
+    if (stats == NULL) {
+        return -EINVAL;
+    }
+    memset(stats, 0, sizeof(*stats));
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_get_all
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queues Pointer to array to fill with queue handles (unused)
+ * @param max_count Maximum number of handles to write (unused)
+ * @return size_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _queue_get_all,   (dmosi_queue_t* queues, size_t max_count) )
+{
+    (void)queues;
+    (void)max_count;
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_send_batch
+ *
+ * Backends that can move several items under one lock should override this.
+ * This default falls back to one dmosi_queue_send call per item, so it works
+ * on top of any backend that implements dmosi_queue_send and
+ * dmosi_queue_get_item_size.
+ *
+ * @param queue Queue handle
+ * @param items Pointer to @p count contiguous items to send
+ * @param count Number of items to send
+ * @param timeout_ms Timeout in milliseconds for the first item
+ * @return int Number of items sent, or negative error code if none was sent
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_send_batch,    (dmosi_queue_t queue, const void* items, uint32_t count, int32_t timeout_ms) )
+{
+    if (items == NULL || count == 0) {
+        return -EINVAL;
+    }
+
+    size_t item_size = dmosi_queue_get_item_size(queue);
+    if (item_size == 0) {
+        return -ENOSYS;
+    }
+
+    const uint8_t* item = items;
+    uint32_t sent = 0;
+    while (sent < count) {
+        // Only the first item may block - see dmosi_queue_send_batch
+        int result = dmosi_queue_send(queue, item, (sent == 0) ? timeout_ms : 0);
+        if (result != 0) {
+            return (sent == 0) ? result : (int)sent;
+        }
+        item += item_size;
+        sent++;
+    }
+    return (int)sent;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_receive_batch
+ *
+ * Backends that can move several items under one lock should override this.
+ * This default falls back to one dmosi_queue_receive call per item, so it
+ * works on top of any backend that implements dmosi_queue_receive and
+ * dmosi_queue_get_item_size.
+ *
+ * @param queue Queue handle
+ * @param items Pointer to a buffer with room for @p max_count contiguous items
+ * @param max_count Maximum number of items to receive
+ * @param timeout_ms Timeout in milliseconds for the first item
+ * @return int Number of items received, or negative error code if none was received
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_receive_batch, (dmosi_queue_t queue, void* items, uint32_t max_count, int32_t timeout_ms) )
+{
+    if (items == NULL || max_count == 0) {
+        return -EINVAL;
+    }
+
+    size_t item_size = dmosi_queue_get_item_size(queue);
+    if (item_size == 0) {
+        return -ENOSYS;
+    }
+
+    uint8_t* item = items;
+    uint32_t received = 0;
+    while (received < max_count) {
+        // Only the first item may block - see dmosi_queue_receive_batch
+        int result = dmosi_queue_receive(queue, item, (received == 0) ? timeout_ms : 0);
+        if (result != 0) {
+            return (received == 0) ? result : (int)received;
+        }
+        item += item_size;
+        received++;
+    }
+    return (int)received;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_reserve_send
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in, or the backend does not support
+ * zero-copy access to its queue storage.
+ *
+ * @param queue Queue handle (unused)
+ * @param slot Set to NULL if not NULL
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_reserve_send,   (dmosi_queue_t queue, void** slot, int32_t timeout_ms) )
+{
+    (void)queue;
+    (void)timeout_ms;
+    if (slot != NULL) {
+        *slot = NULL;
+    }
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_commit_send
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param slot Reserved slot (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_commit_send,    (dmosi_queue_t queue, void* slot) )
+{
+    (void)queue;
+    (void)slot;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_peek_receive
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in, or the backend does not support
+ * zero-copy access to its queue storage.
+ *
+ * @param queue Queue handle (unused)
+ * @param slot Set to NULL if not NULL
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_peek_receive,   (dmosi_queue_t queue, const void** slot, int32_t timeout_ms) )
+{
+    (void)queue;
+    (void)timeout_ms;
+    if (slot != NULL) {
+        *slot = NULL;
+    }
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_queue_release_receive
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param queue Queue handle (unused)
+ * @param slot Peeked slot (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _queue_release_receive, (dmosi_queue_t queue, const void* slot) )
+{
+    (void)queue;
+    (void)slot;
+    return -ENOSYS;
+}
+
+//==============================================================================
+//                              Message Buffer API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_msgbuf_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param buffer_size Total size of the byte ring (unused)
+ * @return dmosi_msgbuf_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_msgbuf_t, _msgbuf_create,  (size_t buffer_size) )
+{
+    (void)buffer_size;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_msgbuf_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param msgbuf Message buffer handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _msgbuf_destroy, (dmosi_msgbuf_t msgbuf) )
+{
+    (void)msgbuf;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_msgbuf_send
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param msgbuf Message buffer handle (unused)
+ * @param data Pointer to the message payload (unused)
+ * @param length Length of the message (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _msgbuf_send,    (dmosi_msgbuf_t msgbuf, const void* data, size_t length, int32_t timeout_ms) )
+{
+    (void)msgbuf;
+    (void)data;
+    (void)length;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_msgbuf_receive
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param msgbuf Message buffer handle (unused)
+ * @param buffer Pointer to buffer to receive the message (unused)
+ * @param buffer_size Size of the buffer (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _msgbuf_receive, (dmosi_msgbuf_t msgbuf, void* buffer, size_t buffer_size, int32_t timeout_ms) )
+{
+    (void)msgbuf;
+    (void)buffer;
+    (void)buffer_size;
+    (void)timeout_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_msgbuf_next_length
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param msgbuf Message buffer handle (unused)
+ * @return size_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, size_t, _msgbuf_next_length, (dmosi_msgbuf_t msgbuf) )
+{
+    (void)msgbuf;
+    return 0;
+}
+
+//==============================================================================
+//                              Ring Buffer API
+//==============================================================================
+/*
+ * Unlike the rest of this file, these are complete implementations rather than
+ * stubs - a ring buffer is not a kernel object, so there is nothing for a
+ * backend to provide. They are still declared weak like every other dmosi API.
+ *
+ * head and tail are free-running counters: the number of stored items is
+ * always head - tail (modulo 2^32), and the slot of a counter value is
+ * (value & mask). Each index has exactly one writer, so a release store by the
+ * owner paired with an acquire load by the other side is all the
+ * synchronization needed.
+ */
+
+/**
+ * @brief Copy @p count items into the ring buffer storage starting at @p index, wrapping around
+ */
+static void dmosi_ringbuf_copy_in(dmosi_ringbuf_t* ringbuf, uint32_t index, const uint8_t* src, uint32_t count)
+{
+    uint32_t offset = index & ringbuf->mask;
+    uint32_t first  = ringbuf->mask + 1 - offset;
+    if (first > count) {
+        first = count;
+    }
+    memcpy(ringbuf->storage + (size_t)offset * ringbuf->item_size, src, (size_t)first * ringbuf->item_size);
+    memcpy(ringbuf->storage, src + (size_t)first * ringbuf->item_size, (size_t)(count - first) * ringbuf->item_size);
+}
+
+/**
+ * @brief Copy @p count items out of the ring buffer storage starting at @p index, wrapping around
+ */
+static void dmosi_ringbuf_copy_out(const dmosi_ringbuf_t* ringbuf, uint32_t index, uint8_t* dst, uint32_t count)
+{
+    uint32_t offset = index & ringbuf->mask;
+    uint32_t first  = ringbuf->mask + 1 - offset;
+    if (first > count) {
+        first = count;
+    }
+    memcpy(dst, ringbuf->storage + (size_t)offset * ringbuf->item_size, (size_t)first * ringbuf->item_size);
+    memcpy(dst + (size_t)first * ringbuf->item_size, ringbuf->storage, (size_t)(count - first) * ringbuf->item_size);
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_init
+ *
+ * @param ringbuf Ring buffer control block to initialize
+ * @param storage Caller-provided item storage
+ * @param item_size Size of each item in bytes
+ * @param capacity Maximum number of items (must be a power of two)
+ * @return int 0 on success, -EINVAL on invalid arguments
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _ringbuf_init,    (dmosi_ringbuf_t* ringbuf, void* storage, size_t item_size, uint32_t capacity) )
+{
+    if (ringbuf == NULL || storage == NULL || item_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return -EINVAL;
+    }
+
+    memset(ringbuf, 0, sizeof(*ringbuf));
+    ringbuf->storage   = storage;
+    ringbuf->item_size = item_size;
+    ringbuf->mask      = capacity - 1;
+    return 0;
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_push
+ *
+ * @param ringbuf Ring buffer
+ * @param item Pointer to the item to copy in
+ * @return int 0 on success, -EAGAIN if full, -EINVAL on invalid arguments
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _ringbuf_push,    (dmosi_ringbuf_t* ringbuf, const void* item) )
+{
+    if (ringbuf == NULL || item == NULL) {
+        return -EINVAL;
+    }
+    return (dmosi_ringbuf_push_n(ringbuf, item, 1) == 1) ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_pop
+ *
+ * @param ringbuf Ring buffer
+ * @param item Pointer to buffer to copy the item into
+ * @return int 0 on success, -EAGAIN if empty, -EINVAL on invalid arguments
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _ringbuf_pop,     (dmosi_ringbuf_t* ringbuf, void* item) )
+{
+    if (ringbuf == NULL || item == NULL) {
+        return -EINVAL;
+    }
+    return (dmosi_ringbuf_pop_n(ringbuf, item, 1) == 1) ? 0 : -EAGAIN;
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_push_n
+ *
+ * @param ringbuf Ring buffer
+ * @param items Pointer to @p count contiguous items
+ * @param count Number of items to push
+ * @return uint32_t Number of items actually pushed
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _ringbuf_push_n,  (dmosi_ringbuf_t* ringbuf, const void* items, uint32_t count) )
+{
+    if (ringbuf == NULL || items == NULL) {
+        return 0;
+    }
+
+    uint32_t head = dmosi_atomic_load_u32(&ringbuf->head, DMOSI_MEMORY_ORDER_RELAXED);
+    uint32_t tail = dmosi_atomic_load_u32(&ringbuf->tail, DMOSI_MEMORY_ORDER_ACQUIRE);
+    uint32_t space = ringbuf->mask + 1 - (head - tail);
+    if (count > space) {
+        count = space;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    dmosi_ringbuf_copy_in(ringbuf, head, items, count);
+
+    // Publish the items only once they are fully written
+    dmosi_atomic_store_u32(&ringbuf->head, head + count, DMOSI_MEMORY_ORDER_RELEASE);
+    return count;
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_pop_n
+ *
+ * @param ringbuf Ring buffer
+ * @param items Pointer to a buffer with room for @p max_count contiguous items
+ * @param max_count Maximum number of items to pop
+ * @return uint32_t Number of items actually popped
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _ringbuf_pop_n,   (dmosi_ringbuf_t* ringbuf, void* items, uint32_t max_count) )
+{
+    if (ringbuf == NULL || items == NULL) {
+        return 0;
+    }
+
+    uint32_t tail = dmosi_atomic_load_u32(&ringbuf->tail, DMOSI_MEMORY_ORDER_RELAXED);
+    uint32_t head = dmosi_atomic_load_u32(&ringbuf->head, DMOSI_MEMORY_ORDER_ACQUIRE);
+    uint32_t count = head - tail;
+    if (count > max_count) {
+        count = max_count;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    dmosi_ringbuf_copy_out(ringbuf, tail, items, count);
+
+    // Hand the slots back to the producer only once they are fully read
+    dmosi_atomic_store_u32(&ringbuf->tail, tail + count, DMOSI_MEMORY_ORDER_RELEASE);
+    return count;
+}
+
+/**
+ * @brief Generic implementation of dmosi_ringbuf_count
+ *
+ * @param ringbuf Ring buffer
+ * @return uint32_t Number of items in the ring buffer, 0 if @p ringbuf is NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _ringbuf_count,   (const dmosi_ringbuf_t* ringbuf) )
+{
+    if (ringbuf == NULL) {
+        return 0;
+    }
+    uint32_t tail = dmosi_atomic_load_u32(&ringbuf->tail, DMOSI_MEMORY_ORDER_ACQUIRE);
+    uint32_t head = dmosi_atomic_load_u32(&ringbuf->head, DMOSI_MEMORY_ORDER_ACQUIRE);
+    return head - tail;
+}
+
+//==============================================================================
+//                              Timer API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_timer_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param callback Callback function to execute when timer expires (unused)
+ * @param arg Argument to pass to the callback function (unused)
+ * @param period_ms Timer period in milliseconds (unused)
+ * @param auto_reload Whether the timer should auto-reload (unused)
+ * @return dmosi_timer_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_timer_t, _timer_create,  (dmosi_timer_callback_t callback, void* arg, uint32_t period_ms, bool auto_reload) )
+{
+    (void)callback;
+    (void)arg;
+    (void)period_ms;
+    (void)auto_reload;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_create_static
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param callback Callback function to execute when timer expires (unused)
+ * @param arg Argument to pass to the callback function (unused)
+ * @param period_ms Timer period in milliseconds (unused)
+ * @param auto_reload Whether the timer should auto-reload (unused)
+ * @param storage Control block storage (unused)
+ * @return dmosi_timer_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_timer_t, _timer_create_static, (dmosi_timer_callback_t callback, void* arg, uint32_t period_ms, bool auto_reload, dmosi_timer_storage_t* storage) )
+{
+    (void)callback;
+    (void)arg;
+    (void)period_ms;
+    (void)auto_reload;
+    (void)storage;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param timer Timer handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _timer_destroy, (dmosi_timer_t timer) )
+{
+    (void)timer;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_start
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param timer Timer handle to start (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_start,   (dmosi_timer_t timer) )
+{
+    (void)timer;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_stop
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param timer Timer handle to stop (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_stop,    (dmosi_timer_t timer) )
+{
+    (void)timer;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_reset
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param timer Timer handle to reset (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_reset,   (dmosi_timer_t timer) )
+{
+    (void)timer;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_set_period
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param timer Timer handle (unused)
+ * @param period_ms New timer period in milliseconds (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_set_period, (dmosi_timer_t timer, uint32_t period_ms) )
+{
+    (void)timer;
+    (void)period_ms;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_timer_get_period
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param timer Timer handle (unused)
+ * @return uint32_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _timer_get_period, (dmosi_timer_t timer) )
+{
+    (void)timer;
+    return 0;
+}
+
+//==============================================================================
+//                              Wait Set API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_waitset_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param max_members Maximum number of members (unused)
+ * @return dmosi_waitset_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_waitset_t, _waitset_create,  (uint32_t max_members) )
+{
+    (void)max_members;
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_waitset_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param set Wait set handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _waitset_destroy, (dmosi_waitset_t set) )
+{
+    (void)set;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_waitset_add
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param set Wait set handle (unused)
+ * @param type Kind of object being added (unused)
+ * @param object Object handle (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _waitset_add,     (dmosi_waitset_t set, dmosi_waitset_member_type_t type, void* object) )
+{
+    (void)set;
+    (void)type;
+    (void)object;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_waitset_remove
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param set Wait set handle (unused)
+ * @param object Object handle (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _waitset_remove,  (dmosi_waitset_t set, void* object) )
+{
+    (void)set;
+    (void)object;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_waitset_wait
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param set Wait set handle (unused)
+ * @param timeout_ms Timeout in milliseconds (unused)
+ * @param ready Member that became ready (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _waitset_wait,    (dmosi_waitset_t set, int32_t timeout_ms, dmosi_waitset_member_t* ready) )
+{
+    (void)set;
+    (void)timeout_ms;
+    (void)ready;
+    return -ENOSYS;
+}
+
+//==============================================================================
+//                              Work Queue API
+//==============================================================================
+/*
+ * Generic implementation on top of the thread, mutex and condition variable
+ * APIs. Pending jobs are kept in a list sorted by due tick, which keeps
+ * delayed submission and cancellation simple; workers sleep on a condition
+ * variable until the first job is due or a new one is submitted.
+ */
+
+/**
+ * @brief A pending job of the generic work queue
+ */
+typedef struct dmosi_work {
+    struct dmosi_work* next;    //!< Next pending job (later or equal due tick)
+    dmosi_work_fn_t    fn;      //!< Job function
+    void*              arg;     //!< Argument of fn
+    uint32_t           due;     //!< Tick count at which the job may start
+    int32_t            id;      //!< Job id returned to the submitter
+} dmosi_work_t;
+
+/**
+ * @brief Control block of the generic work queue
+ */
+struct dmosi_workqueue {
+    dmosi_mutex_t   lock;           //!< Protects everything below
+    dmosi_cond_t    work_ready;     //!< Signalled when a job is submitted or on stop
+    dmosi_cond_t    idle;           //!< Broadcast when the queue becomes idle
+    dmosi_work_t*   pending;        //!< Pending jobs, sorted by due tick
+    uint32_t        running;        //!< Jobs currently being run
+    int32_t         next_id;        //!< Id of the next submitted job
+    bool            stop;           //!< Set by dmosi_workqueue_destroy
+    uint32_t        worker_count;   //!< Number of entries in workers
+    dmosi_thread_t  workers[];      //!< Worker threads
+};
+
+/**
+ * @brief Entry function of the generic work queue workers
+ */
+static void dmosi_workqueue_worker(void* arg)
+{
+    struct dmosi_workqueue* workqueue = arg;
+
+    dmosi_mutex_lock(workqueue->lock);
+    while (!workqueue->stop) {
+        dmosi_work_t* work = workqueue->pending;
+        int32_t timeout_ms = -1;
+        if (work != NULL) {
+            int32_t remaining = (int32_t)(work->due - dmosi_get_tick_count());
+            if (remaining <= 0) {
+                workqueue->pending = work->next;
+                workqueue->running++;
+                dmosi_mutex_unlock(workqueue->lock);
+
+                work->fn(work->arg);
+                Dmod_Free(work);
+
+                dmosi_mutex_lock(workqueue->lock);
+                workqueue->running--;
+                if (workqueue->running == 0 && workqueue->pending == NULL) {
+                    dmosi_cond_broadcast(workqueue->idle);
+                }
+                continue;
+            }
+            timeout_ms = remaining;
+        }
+        dmosi_cond_wait(workqueue->work_ready, workqueue->lock, timeout_ms);
+    }
+    dmosi_mutex_unlock(workqueue->lock);
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_destroy
+ *
+ * @param workqueue Work queue handle to destroy
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _workqueue_destroy, (dmosi_workqueue_t workqueue) )
+{
+    if (workqueue == NULL) {
+        return;
+    }
+
+    if (workqueue->lock != NULL && workqueue->work_ready != NULL) {
+        dmosi_mutex_lock(workqueue->lock);
+        workqueue->stop = true;
+        dmosi_cond_broadcast(workqueue->work_ready);
+        dmosi_mutex_unlock(workqueue->lock);
+    }
+
+    for (uint32_t i = 0; i < workqueue->worker_count; i++) {
+        if (workqueue->workers[i] != NULL) {
+            dmosi_thread_join(workqueue->workers[i]);
+            dmosi_thread_destroy(workqueue->workers[i]);
+        }
+    }
+
+    while (workqueue->pending != NULL) {
+        dmosi_work_t* work = workqueue->pending;
+        workqueue->pending = work->next;
+        Dmod_Free(work);
+    }
+
+    if (workqueue->idle != NULL) {
+        dmosi_cond_destroy(workqueue->idle);
+    }
+    if (workqueue->work_ready != NULL) {
+        dmosi_cond_destroy(workqueue->work_ready);
+    }
+    if (workqueue->lock != NULL) {
+        dmosi_mutex_destroy(workqueue->lock);
+    }
+    Dmod_Free(workqueue);
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_create
+ *
+ * @param worker_count Number of worker threads
+ * @param priority Priority of the worker threads
+ * @param stack_size Stack size of each worker thread
+ * @param name Name of the worker threads
+ * @return dmosi_workqueue_t Created work queue handle, NULL on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_workqueue_t, _workqueue_create, (uint32_t worker_count, int priority, size_t stack_size, const char* name) )
+{
+    if (worker_count == 0 || name == NULL) {
+        return NULL;
+    }
+
+    struct dmosi_workqueue* workqueue = Dmod_Malloc(sizeof(struct dmosi_workqueue) + worker_count * sizeof(dmosi_thread_t));
+    if (workqueue == NULL) {
+        return NULL;
+    }
+    memset(workqueue, 0, sizeof(struct dmosi_workqueue) + worker_count * sizeof(dmosi_thread_t));
+    workqueue->next_id      = 1;
+    workqueue->lock         = dmosi_mutex_create(false);
+    workqueue->work_ready   = dmosi_cond_create();
+    workqueue->idle         = dmosi_cond_create();
+    if (workqueue->lock == NULL || workqueue->work_ready == NULL || workqueue->idle == NULL) {
+        dmosi_workqueue_destroy(workqueue);
+        return NULL;
+    }
+
+    workqueue->worker_count = worker_count;
+    for (uint32_t i = 0; i < worker_count; i++) {
+        workqueue->workers[i] = dmosi_thread_create(dmosi_workqueue_worker, workqueue, priority, stack_size, name, NULL);
+        if (workqueue->workers[i] == NULL) {
+            dmosi_workqueue_destroy(workqueue);
+            return NULL;
+        }
+    }
+    return workqueue;
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_submit_delayed
+ *
+ * @param workqueue Work queue handle
+ * @param fn Job function
+ * @param arg Argument passed to fn
+ * @param delay_ms Minimum delay before the job starts, in milliseconds
+ * @return int32_t Positive job id, negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int32_t, _workqueue_submit_delayed, (dmosi_workqueue_t workqueue, dmosi_work_fn_t fn, void* arg, uint32_t delay_ms) )
+{
+    if (workqueue == NULL || fn == NULL || delay_ms > INT32_MAX) {
+        return -EINVAL;
+    }
+
+    dmosi_work_t* work = Dmod_Malloc(sizeof(dmosi_work_t));
+    if (work == NULL) {
+        return -ENOMEM;
+    }
+    work->fn  = fn;
+    work->arg = arg;
+
+    int result = dmosi_mutex_lock(workqueue->lock);
+    if (result != 0) {
+        Dmod_Free(work);
+        return result;
+    }
+
+    work->id  = workqueue->next_id;
+    workqueue->next_id = (workqueue->next_id == INT32_MAX) ? 1 : workqueue->next_id + 1;
+    work->due = dmosi_get_tick_count() + delay_ms;
+
+    // Insert after every job due no later, keeping FIFO order among equals
+    dmosi_work_t** link = &workqueue->pending;
+    while (*link != NULL && (int32_t)((*link)->due - work->due) <= 0) {
+        link = &(*link)->next;
+    }
+    work->next = *link;
+    *link = work;
+
+    // A new head may be due earlier than what the sleeping workers wait for
+    dmosi_cond_signal(workqueue->work_ready);
+    int32_t id = work->id;
+    dmosi_mutex_unlock(workqueue->lock);
+    return id;
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_submit
+ *
+ * @param workqueue Work queue handle
+ * @param fn Job function
+ * @param arg Argument passed to fn
+ * @return int32_t Positive job id, negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int32_t, _workqueue_submit, (dmosi_workqueue_t workqueue, dmosi_work_fn_t fn, void* arg) )
+{
+    return dmosi_workqueue_submit_delayed(workqueue, fn, arg, 0);
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_cancel
+ *
+ * @param workqueue Work queue handle
+ * @param id Job id
+ * @return int 0 if the job was removed, -ENOENT if not pending, other negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _workqueue_cancel, (dmosi_workqueue_t workqueue, int32_t id) )
+{
+    if (workqueue == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(workqueue->lock);
+    if (result != 0) {
+        return result;
+    }
+
+    result = -ENOENT;
+    for (dmosi_work_t** link = &workqueue->pending; *link != NULL; link = &(*link)->next) {
+        dmosi_work_t* work = *link;
+        if (work->id == id) {
+            *link = work->next;
+            Dmod_Free(work);
+            result = 0;
+            break;
+        }
+    }
+    if (result == 0 && workqueue->pending == NULL && workqueue->running == 0) {
+        dmosi_cond_broadcast(workqueue->idle);
+    }
+
+    dmosi_mutex_unlock(workqueue->lock);
+    return result;
+}
+
+/**
+ * @brief Generic implementation of dmosi_workqueue_drain
+ *
+ * @param workqueue Work queue handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once idle, -ETIMEDOUT on timeout, other negative error code on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _workqueue_drain, (dmosi_workqueue_t workqueue, int32_t timeout_ms) )
+{
+    if (workqueue == NULL) {
+        return -EINVAL;
+    }
+
+    int result = dmosi_mutex_lock(workqueue->lock);
+    if (result != 0) {
+        return result;
+    }
+
+    uint32_t start = dmosi_get_tick_count();
+    while (workqueue->pending != NULL || workqueue->running > 0) {
+        int32_t remaining = -1;
+        if (timeout_ms >= 0) {
+            remaining = timeout_ms - (int32_t)(dmosi_get_tick_count() - start);
+            if (remaining <= 0) {
+                result = -ETIMEDOUT;
+                break;
+            }
+        }
+        result = dmosi_cond_wait(workqueue->idle, workqueue->lock, remaining);
+        if (result != 0 && result != -ETIMEDOUT) {
+            break;
+        }
+        result = 0;
+    }
+
+    dmosi_mutex_unlock(workqueue->lock);
+    return result;
+}
+
+//==============================================================================
+//                              Task Pool API
+//==============================================================================
+/*
+ * Generic work-stealing implementation. Each worker owns a fixed-size
+ * Chase-Lev deque (memory orders after Le et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models"): the owner pushes and pops
+ * at the bottom with no read-modify-write operation except when taking the
+ * very last task, thieves take from the top with a single compare-and-swap.
+ * Tasks spawned from outside the pool go through a mutex-protected injection
+ * list. Workers that found nothing for DMOSI_TASK_IDLE_ROUNDS rounds park on
+ * a condition variable, with no timeout, until a spawn wakes them: a worker
+ * registers as a sleeper before its last look for work and a spawn checks
+ * for sleepers after publishing its task, with a full fence on both sides,
+ * so either the worker finds the task or the spawn finds the sleeper.
+ * A worker waiting for a task in dmosi_task_wait helps with other tasks and
+ * parks on the same condition variable once it runs out of them; the
+ * completion of a task waited for by a worker broadcasts it as well.
+ *
+ * pending counts the task's own function plus its unfinished children; the
+ * task completes when it drops to zero, which in turn finishes one unit of
+ * its parent's pending. refs counts the handle and the completion, and
+ * whichever is released last frees the task.
+ */
+
+/**
+ * @brief Index mask of the task deques
+ */
+#define DMOSI_TASK_DEQUE_MASK       ((uint32_t)DMOSI_TASK_DEQUE_SIZE - 1u)
+
+/**
+ * @brief Rounds of looking for work before an idle worker goes to sleep
+ */
+#define DMOSI_TASK_IDLE_ROUNDS      64
+
+/**
+ * @brief Values of dmosi_task::waiting - who to notify when the task completes
+ */
+#define DMOSI_TASK_WAITER_EXTERNAL  1u  //!< A thread outside the pool, on completed
+#define DMOSI_TASK_WAITER_WORKER    2u  //!< A worker of the pool, on work_ready
+
+/**
+ * @brief Control block of a task of the generic task pool
+ */
+struct dmosi_task {
+    struct dmosi_task_pool* pool;       //!< Pool the task was spawned in
+    struct dmosi_task*      parent;     //!< Parent task, NULL for a root task
+    struct dmosi_task*      next;       //!< Next task in the injection list
+    dmosi_task_fn_t         fn;         //!< Task function
+    void*                   arg;        //!< Argument of fn
+    uint32_t                pending;    //!< Own function + unfinished children
+    uint32_t                refs;       //!< Handle + completion
+    uint32_t                done;       //!< Non-zero once completed
+    uint32_t                waiting;    //!< DMOSI_TASK_WAITER_* of the thread waiting for it, 0 if none
+};
+
+/**
+ * @brief A worker of the generic task pool and its deque
+ */
+typedef struct {
+    uint32_t                top;                                            //!< Next index to steal (thieves)
+    uint8_t                 top_pad[DMOSI_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    uint32_t                bottom;                                         //!< Next index to push (owner)
+    uint8_t                 bottom_pad[DMOSI_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    void*                   tasks[DMOSI_TASK_DEQUE_SIZE];                   //!< Deque slots (struct dmosi_task*)
+    struct dmosi_task_pool* pool;                                           //!< Pool of the worker
+    dmosi_thread_t          thread;                                         //!< Worker thread, for joining
+    void*                   self;                                           //!< dmosi_thread_current() of the worker
+    uint32_t                random;                                         //!< Victim selection state
+} dmosi_task_worker_t;
+
+/**
+ * @brief Control block of the generic task pool
+ */
+struct dmosi_task_pool {
+    dmosi_mutex_t           lock;           //!< Protects the injection list and sleeping
+    dmosi_cond_t            work_ready;     //!< Signalled to wake a sleeping worker, broadcast on completions waited by a worker
+    dmosi_cond_t            completed;      //!< Broadcast on externally waited completions
+    struct dmosi_task*      injected_head;  //!< Tasks spawned from outside the pool
+    struct dmosi_task*      injected_tail;  //!< Last task of the injection list
+    uint32_t                injected_count; //!< Number of tasks in the injection list
+    uint32_t                sleepers;       //!< Workers sleeping on work_ready, idle or waiting for a task
+    uint32_t                outstanding;    //!< Spawned tasks not completed yet
+    uint32_t                stop;           //!< Set by dmosi_task_pool_destroy
+    uint32_t                worker_count;   //!< Number of entries in workers
+    dmosi_task_worker_t     workers[];      //!< Workers
+};
+
+/**
+ * @brief Push a task at the bottom of the worker's own deque
+ *
+ * @return bool false if the deque is full
+ */
+static bool dmosi_task_deque_push(dmosi_task_worker_t* worker, struct dmosi_task* task)
+{
+    uint32_t bottom = dmosi_atomic_load_u32(&worker->bottom, DMOSI_MEMORY_ORDER_RELAXED);
+    uint32_t top    = dmosi_atomic_load_u32(&worker->top, DMOSI_MEMORY_ORDER_ACQUIRE);
+    if (bottom - top > DMOSI_TASK_DEQUE_MASK) {
+        return false;
+    }
+    dmosi_atomic_store_ptr(&worker->tasks[bottom & DMOSI_TASK_DEQUE_MASK], task, DMOSI_MEMORY_ORDER_RELAXED);
+    dmosi_atomic_store_u32(&worker->bottom, bottom + 1, DMOSI_MEMORY_ORDER_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Pop the most recently pushed task from the worker's own deque
+ */
+static struct dmosi_task* dmosi_task_deque_pop(dmosi_task_worker_t* worker)
+{
+    uint32_t bottom = dmosi_atomic_load_u32(&worker->bottom, DMOSI_MEMORY_ORDER_RELAXED) - 1;
+    dmosi_atomic_store_u32(&worker->bottom, bottom, DMOSI_MEMORY_ORDER_RELAXED);
+    dmosi_atomic_thread_fence(DMOSI_MEMORY_ORDER_SEQ_CST);
+    uint32_t top = dmosi_atomic_load_u32(&worker->top, DMOSI_MEMORY_ORDER_RELAXED);
+
+    if ((int32_t)(bottom - top) < 0) {
+        dmosi_atomic_store_u32(&worker->bottom, bottom + 1, DMOSI_MEMORY_ORDER_RELAXED);
+        return NULL;
+    }
+
+    struct dmosi_task* task = dmosi_atomic_load_ptr(&worker->tasks[bottom & DMOSI_TASK_DEQUE_MASK], DMOSI_MEMORY_ORDER_RELAXED);
+    if (bottom == top) {
+        // Last task: race the thieves for it
+        if (!dmosi_atomic_compare_exchange_u32(&worker->top, &top, top + 1, DMOSI_MEMORY_ORDER_SEQ_CST, DMOSI_MEMORY_ORDER_RELAXED)) {
+            task = NULL;
+        }
+        dmosi_atomic_store_u32(&worker->bottom, bottom + 1, DMOSI_MEMORY_ORDER_RELAXED);
+    }
+    return task;
+}
+
+/**
+ * @brief Steal the oldest task from another worker's deque
+ */
+static struct dmosi_task* dmosi_task_deque_steal(dmosi_task_worker_t* victim)
+{
+    uint32_t top = dmosi_atomic_load_u32(&victim->top, DMOSI_MEMORY_ORDER_ACQUIRE);
+    dmosi_atomic_thread_fence(DMOSI_MEMORY_ORDER_SEQ_CST);
+    uint32_t bottom = dmosi_atomic_load_u32(&victim->bottom, DMOSI_MEMORY_ORDER_ACQUIRE);
+    if ((int32_t)(bottom - top) <= 0) {
+        return NULL;
+    }
+
+    struct dmosi_task* task = dmosi_atomic_load_ptr(&victim->tasks[top & DMOSI_TASK_DEQUE_MASK], DMOSI_MEMORY_ORDER_RELAXED);
+    if (!dmosi_atomic_compare_exchange_u32(&victim->top, &top, top + 1, DMOSI_MEMORY_ORDER_SEQ_CST, DMOSI_MEMORY_ORDER_RELAXED)) {
+        return NULL;
+    }
+    return task;
+}
+
+/**
+ * @brief Find the worker of @p pool the calling thread is, NULL if none
+ */
+static dmosi_task_worker_t* dmosi_task_pool_current_worker(struct dmosi_task_pool* pool)
+{
+    void* current = dmosi_thread_current();
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        if (dmosi_atomic_load_ptr(&pool->workers[i].self, DMOSI_MEMORY_ORDER_RELAXED) == current) {
+            return &pool->workers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Whether any task is waiting to be run in @p pool
+ */
+static bool dmosi_task_pool_has_work(struct dmosi_task_pool* pool)
+{
+    if (dmosi_atomic_load_u32(&pool->injected_count, DMOSI_MEMORY_ORDER_SEQ_CST) > 0) {
+        return true;
+    }
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        dmosi_task_worker_t* worker = &pool->workers[i];
+        uint32_t top    = dmosi_atomic_load_u32(&worker->top, DMOSI_MEMORY_ORDER_SEQ_CST);
+        uint32_t bottom = dmosi_atomic_load_u32(&worker->bottom, DMOSI_MEMORY_ORDER_SEQ_CST);
+        if ((int32_t)(bottom - top) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Wake one sleeping worker, if any, after work was made available
+ */
+static void dmosi_task_pool_wake_worker(struct dmosi_task_pool* pool)
+{
+    // Pairs with the fence in dmosi_task_worker: either the worker sees the
+    // new task before sleeping, or this sees the worker as a sleeper
+    dmosi_atomic_thread_fence(DMOSI_MEMORY_ORDER_SEQ_CST);
+    if (dmosi_atomic_load_u32(&pool->sleepers, DMOSI_MEMORY_ORDER_RELAXED) > 0) {
+        dmosi_mutex_lock(pool->lock);
+        dmosi_cond_signal(pool->work_ready);
+        dmosi_mutex_unlock(pool->lock);
+    }
+}
+
+/**
+ * @brief Find a task to run: own deque first, then the injection list, then a random victim
+ *
+ * @param worker Calling worker, NULL if the caller is not a worker of @p pool
+ */
+static struct dmosi_task* dmosi_task_pool_find_work(struct dmosi_task_pool* pool, dmosi_task_worker_t* worker)
+{
+    struct dmosi_task* task = NULL;
+    if (worker != NULL) {
+        task = dmosi_task_deque_pop(worker);
+        if (task != NULL) {
+            return task;
+        }
+    }
+
+    if (dmosi_atomic_load_u32(&pool->injected_count, DMOSI_MEMORY_ORDER_ACQUIRE) > 0) {
+        dmosi_mutex_lock(pool->lock);
+        task = pool->injected_head;
+        if (task != NULL) {
+            pool->injected_head = task->next;
+            if (pool->injected_head == NULL) {
+                pool->injected_tail = NULL;
+            }
+            dmosi_atomic_fetch_sub_u32(&pool->injected_count, 1, DMOSI_MEMORY_ORDER_RELAXED);
+        }
+        dmosi_mutex_unlock(pool->lock);
+        if (task != NULL) {
+            return task;
+        }
+    }
+
+    uint32_t start = 0;
+    if (worker != NULL) {
+        // xorshift32
+        uint32_t random = worker->random;
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        worker->random = random;
+        start = random % pool->worker_count;
+    }
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        dmosi_task_worker_t* victim = &pool->workers[(start + i) % pool->worker_count];
+        if (victim != worker) {
+            task = dmosi_task_deque_steal(victim);
+            if (task != NULL) {
+                return task;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Drop one reference to a task, freeing it with the last one
+ */
+static void dmosi_task_release(struct dmosi_task* task)
+{
+    if (dmosi_atomic_fetch_sub_u32(&task->refs, 1, DMOSI_MEMORY_ORDER_ACQ_REL) == 1) {
+        Dmod_Free(task);
+    }
+}
+
+/**
+ * @brief Finish one unit of a task's pending count, completing it and its ancestors as they reach zero
+ */
+static void dmosi_task_finish(struct dmosi_task* task)
+{
+    while (task != NULL && dmosi_atomic_fetch_sub_u32(&task->pending, 1, DMOSI_MEMORY_ORDER_ACQ_REL) == 1) {
+        struct dmosi_task_pool* pool   = task->pool;
+        struct dmosi_task*      parent = task->parent;
+
+        // Pairs with the waiter storing waiting before checking done: either
+        // the waiter sees the task done or this sees the waiter
+        dmosi_atomic_store_u32(&task->done, 1, DMOSI_MEMORY_ORDER_SEQ_CST);
+        uint32_t waiting = dmosi_atomic_load_u32(&task->waiting, DMOSI_MEMORY_ORDER_SEQ_CST);
+        dmosi_task_release(task);
+
+        bool notify = (waiting == DMOSI_TASK_WAITER_EXTERNAL);
+        if (dmosi_atomic_fetch_sub_u32(&pool->outstanding, 1, DMOSI_MEMORY_ORDER_ACQ_REL) == 1) {
+            notify = true;
+        }
+        if (notify || waiting == DMOSI_TASK_WAITER_WORKER) {
+            dmosi_mutex_lock(pool->lock);
+            if (notify) {
+                dmosi_cond_broadcast(pool->completed);
+            }
+            if (waiting == DMOSI_TASK_WAITER_WORKER) {
+                dmosi_cond_broadcast(pool->work_ready);
+            }
+            dmosi_mutex_unlock(pool->lock);
+        }
+        task = parent;
+    }
+}
+
+/**
+ * @brief Run a task's function and finish its own unit of pending
+ */
+static void dmosi_task_run(struct dmosi_task* task)
+{
+    task->fn(task, task->arg);
+    dmosi_task_finish(task);
+}
+
+/**
+ * @brief Entry function of the generic task pool workers
+ */
+static void dmosi_task_worker(void* arg)
+{
+    dmosi_task_worker_t* worker = arg;
+    struct dmosi_task_pool* pool = worker->pool;
+    dmosi_atomic_store_ptr(&worker->self, dmosi_thread_current(), DMOSI_MEMORY_ORDER_RELEASE);
+
+    uint32_t idle_rounds = 0;
+    while (dmosi_atomic_load_u32(&pool->stop, DMOSI_MEMORY_ORDER_ACQUIRE) == 0) {
+        struct dmosi_task* task = dmosi_task_pool_find_work(pool, worker);
+        if (task != NULL) {
+            dmosi_task_run(task);
+            idle_rounds = 0;
+            continue;
+        }
+        if (++idle_rounds < DMOSI_TASK_IDLE_ROUNDS) {
+            continue;
+        }
+
+        dmosi_mutex_lock(pool->lock);
+        dmosi_atomic_fetch_add_u32(&pool->sleepers, 1, DMOSI_MEMORY_ORDER_SEQ_CST);
+        dmosi_atomic_thread_fence(DMOSI_MEMORY_ORDER_SEQ_CST);
+        if (dmosi_atomic_load_u32(&pool->stop, DMOSI_MEMORY_ORDER_RELAXED) == 0 && !dmosi_task_pool_has_work(pool)) {
+            dmosi_cond_wait(pool->work_ready, pool->lock, -1);
+        }
+        dmosi_atomic_fetch_sub_u32(&pool->sleepers, 1, DMOSI_MEMORY_ORDER_RELAXED);
+        dmosi_mutex_unlock(pool->lock);
+        idle_rounds = 0;
+    }
+}
+
+/**
+ * @brief Generic implementation of dmosi_task_pool_destroy
+ *
+ * @param pool Task pool handle to destroy
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _task_pool_destroy, (dmosi_task_pool_t pool) )
+{
+    if (pool == NULL) {
+        return;
+    }
+
+    if (pool->lock != NULL && pool->work_ready != NULL && pool->completed != NULL) {
+        dmosi_mutex_lock(pool->lock);
+        while (dmosi_atomic_load_u32(&pool->outstanding, DMOSI_MEMORY_ORDER_ACQUIRE) > 0) {
+            dmosi_cond_wait(pool->completed, pool->lock, -1);
+        }
+        dmosi_atomic_store_u32(&pool->stop, 1, DMOSI_MEMORY_ORDER_RELEASE);
+        dmosi_cond_broadcast(pool->work_ready);
+        dmosi_mutex_unlock(pool->lock);
+    }
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        if (pool->workers[i].thread != NULL) {
+            dmosi_thread_join(pool->workers[i].thread);
+            dmosi_thread_destroy(pool->workers[i].thread);
+        }
+    }
+
+    if (pool->completed != NULL) {
+        dmosi_cond_destroy(pool->completed);
+    }
+    if (pool->work_ready != NULL) {
+        dmosi_cond_destroy(pool->work_ready);
+    }
+    if (pool->lock != NULL) {
+        dmosi_mutex_destroy(pool->lock);
+    }
+    Dmod_Free(pool);
+}
+
+/**
+ * @brief Generic implementation of dmosi_task_pool_create
+ *
+ * @param worker_count Number of worker threads (0 = one per core)
+ * @param priority Priority of the worker threads
+ * @param stack_size Stack size of each worker thread
+ * @param name Name of the worker threads
+ * @return dmosi_task_pool_t Created task pool handle, NULL on failure
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_task_pool_t, _task_pool_create, (uint32_t worker_count, int priority, size_t stack_size, const char* name) )
+{
+    if (name == NULL) {
+        return NULL;
+    }
+    uint32_t core_count = dmosi_get_core_count();
+    if (worker_count == 0) {
+        worker_count = (core_count > 0) ? core_count : 1;
+    }
+
+    // Workers are only pinned to the cores a dmosi_cpu_mask_t can name
+    uint32_t pin_cores = (core_count > DMOSI_CPU_MASK_BITS) ? DMOSI_CPU_MASK_BITS : core_count;
+
+    size_t size = sizeof(struct dmosi_task_pool) + worker_count * sizeof(dmosi_task_worker_t);
+    struct dmosi_task_pool* pool = Dmod_Malloc(size);
+    if (pool == NULL) {
+        return NULL;
+    }
+    memset(pool, 0, size);
+    pool->lock       = dmosi_mutex_create(false);
+    pool->work_ready = dmosi_cond_create();
+    pool->completed  = dmosi_cond_create();
+    if (pool->lock == NULL || pool->work_ready == NULL || pool->completed == NULL) {
+        dmosi_task_pool_destroy(pool);
+        return NULL;
+    }
+
+    pool->worker_count = worker_count;
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pool->workers[i].pool   = pool;
+        pool->workers[i].random = (i + 1) * 2654435761u;
+    }
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pool->workers[i].thread = dmosi_thread_create(dmosi_task_worker, &pool->workers[i], priority, stack_size, name, NULL);
+        if (pool->workers[i].thread == NULL) {
+            dmosi_task_pool_destroy(pool);
+            return NULL;
+        }
+        if (pin_cores > 1) {
+            // Best effort: a backend without affinity support just lets the workers float
+            dmosi_thread_set_affinity(pool->workers[i].thread, DMOSI_CPU_MASK(i % pin_cores));
+        }
+    }
+    return pool;
+}
+
 /**
- * @brief Default (weak) implementation of dmosi_timer_stop
+ * @brief Generic implementation of dmosi_task_spawn
  *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param timer Timer handle to stop (unused)
- * @return int Always -ENOSYS
+ * @param pool Task pool handle
+ * @param parent Parent task, NULL for a root task
+ * @param fn Task function
+ * @param arg Argument passed to fn
+ * @return dmosi_task_t Task handle, NULL on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_stop,    (dmosi_timer_t timer) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_task_t, _task_spawn, (dmosi_task_pool_t pool, dmosi_task_t parent, dmosi_task_fn_t fn, void* arg) )
 {
-    (void)timer;
-    return -ENOSYS;
-}
+    if (pool == NULL || fn == NULL) {
+        return NULL;
+    }
 
-/**
- * @brief Default (weak) implementation of dmosi_timer_reset
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
- *
- * @param timer Timer handle to reset (unused)
- * @return int Always -ENOSYS
- */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_reset,   (dmosi_timer_t timer) )
-{
-    (void)timer;
-    return -ENOSYS;
+    struct dmosi_task* task = Dmod_Malloc(sizeof(struct dmosi_task));
+    if (task == NULL) {
+        return NULL;
+    }
+    task->pool    = pool;
+    task->parent  = parent;
+    task->next    = NULL;
+    task->fn      = fn;
+    task->arg     = arg;
+    task->pending = 1;
+    task->refs    = 2;
+    task->done    = 0;
+    task->waiting = 0;
+
+    if (parent != NULL) {
+        dmosi_atomic_fetch_add_u32(&parent->pending, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    }
+    dmosi_atomic_fetch_add_u32(&pool->outstanding, 1, DMOSI_MEMORY_ORDER_RELAXED);
+
+    dmosi_task_worker_t* worker = dmosi_task_pool_current_worker(pool);
+    if (worker != NULL) {
+        if (!dmosi_task_deque_push(worker, task)) {
+            // Deque full: running it right away keeps the spawner depth-first
+            dmosi_task_run(task);
+            return task;
+        }
+    } else {
+        dmosi_mutex_lock(pool->lock);
+        if (pool->injected_tail != NULL) {
+            pool->injected_tail->next = task;
+        } else {
+            pool->injected_head = task;
+        }
+        pool->injected_tail = task;
+        dmosi_atomic_fetch_add_u32(&pool->injected_count, 1, DMOSI_MEMORY_ORDER_RELEASE);
+        dmosi_mutex_unlock(pool->lock);
+    }
+
+    dmosi_task_pool_wake_worker(pool);
+    return task;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_timer_set_period
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_task_wait
  *
- * @param timer Timer handle (unused)
- * @param period_ms New timer period in milliseconds (unused)
- * @return int Always -ENOSYS
+ * @param task Task handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, -1 = wait forever)
+ * @return int 0 once the task has completed, -ETIMEDOUT on timeout, other negative error code on failure
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _timer_set_period, (dmosi_timer_t timer, uint32_t period_ms) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _task_wait, (dmosi_task_t task, int32_t timeout_ms) )
 {
-    (void)timer;
-    (void)period_ms;
-    return -ENOSYS;
+    if (task == NULL) {
+        return -EINVAL;
+    }
+
+    struct dmosi_task_pool* pool = task->pool;
+    uint32_t start = dmosi_get_tick_count();
+    int result = 0;
+
+    dmosi_task_worker_t* worker = dmosi_task_pool_current_worker(pool);
+    if (worker != NULL) {
+        // Help instead of blocking: the awaited task's children may well be
+        // sitting in this very worker's deque. With nothing left to run, sleep
+        // like an idle worker until a spawn or the task's completion wakes it.
+        dmosi_atomic_store_u32(&task->waiting, DMOSI_TASK_WAITER_WORKER, DMOSI_MEMORY_ORDER_SEQ_CST);
+        uint32_t idle_rounds = 0;
+        while (dmosi_atomic_load_u32(&task->done, DMOSI_MEMORY_ORDER_SEQ_CST) == 0) {
+            int32_t remaining = -1;
+            if (timeout_ms >= 0) {
+                remaining = timeout_ms - (int32_t)(dmosi_get_tick_count() - start);
+                if (remaining <= 0) {
+                    result = -ETIMEDOUT;
+                    break;
+                }
+            }
+            struct dmosi_task* other = dmosi_task_pool_find_work(pool, worker);
+            if (other != NULL) {
+                dmosi_task_run(other);
+                idle_rounds = 0;
+                continue;
+            }
+            if (++idle_rounds < DMOSI_TASK_IDLE_ROUNDS) {
+                continue;
+            }
+
+            dmosi_mutex_lock(pool->lock);
+            dmosi_atomic_fetch_add_u32(&pool->sleepers, 1, DMOSI_MEMORY_ORDER_SEQ_CST);
+            dmosi_atomic_thread_fence(DMOSI_MEMORY_ORDER_SEQ_CST);
+            if (dmosi_atomic_load_u32(&task->done, DMOSI_MEMORY_ORDER_SEQ_CST) == 0 && !dmosi_task_pool_has_work(pool)) {
+                dmosi_cond_wait(pool->work_ready, pool->lock, remaining);
+            }
+            dmosi_atomic_fetch_sub_u32(&pool->sleepers, 1, DMOSI_MEMORY_ORDER_RELAXED);
+            dmosi_mutex_unlock(pool->lock);
+            idle_rounds = 0;
+        }
+    } else {
+        dmosi_mutex_lock(pool->lock);
+        dmosi_atomic_store_u32(&task->waiting, DMOSI_TASK_WAITER_EXTERNAL, DMOSI_MEMORY_ORDER_SEQ_CST);
+        while (dmosi_atomic_load_u32(&task->done, DMOSI_MEMORY_ORDER_SEQ_CST) == 0) {
+            int32_t remaining = -1;
+            if (timeout_ms >= 0) {
+                remaining = timeout_ms - (int32_t)(dmosi_get_tick_count() - start);
+                if (remaining <= 0) {
+                    result = -ETIMEDOUT;
+                    break;
+                }
+            }
+            dmosi_cond_wait(pool->completed, pool->lock, remaining);
+        }
+        dmosi_mutex_unlock(pool->lock);
+    }
+
+    if (result == 0) {
+        dmosi_task_release(task);
+    }
+    return result;
 }
 
 /**
- * @brief Default (weak) implementation of dmosi_timer_get_period
- *
- * Overridden by the platform-specific dmosi backend. This default is used
- * when no backend has been linked in.
+ * @brief Generic implementation of dmosi_task_detach
  *
- * @param timer Timer handle (unused)
- * @return uint32_t Always 0
+ * @param task Task handle
  */
-DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _timer_get_period, (dmosi_timer_t timer) )
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _task_detach, (dmosi_task_t task) )
 {
-    (void)timer;
-    return 0;
+    if (task != NULL) {
+        dmosi_task_release(task);
+    }
 }
 
 //==============================================================================
@@ -1182,6 +4041,89 @@ DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _get_min_interrupt_priori
     return 0;
 }
 
+/**
+ * @brief Default (weak) implementation of dmosi_yield_from_isr
+ *
+ * Overridden by the platform-specific dmosi backend, which pends its
+ * context-switch interrupt. This default is a no-op, used when no backend
+ * has been linked in.
+ *
+ * @param higher_priority_woken Flag accumulated from the ISR's _from_isr calls (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _yield_from_isr, (bool higher_priority_woken) )
+{
+    (void)higher_priority_woken;
+}
+
+//==============================================================================
+//                              Critical Section API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_critical_enter
+ *
+ * Overridden by the platform-specific dmosi backend, which masks interrupts
+ * and preemption. This default is a no-op that provides no protection at
+ * all, used when no backend has been linked in.
+ *
+ * @return dmosi_critical_state_t Always 0
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_critical_state_t, _critical_enter, (void) )
+{
+    return 0;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_critical_exit
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a
+ * no-op, used when no backend has been linked in.
+ *
+ * @param state State returned by the matching dmosi_critical_enter (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _critical_exit,  (dmosi_critical_state_t state) )
+{
+    (void)state;
+}
+
+/**
+ * @brief Generic implementation of dmosi_spinlock_lock
+ *
+ * Built on dmosi_critical_enter and an atomic exchange. On a single core the
+ * critical section alone already excludes every other holder, so the
+ * exchange always succeeds at once. Backends may override the pair, e.g. to
+ * wait for events between attempts.
+ *
+ * @param lock Spinlock to acquire
+ * @return dmosi_critical_state_t State to pass to the matching dmosi_spinlock_unlock
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_critical_state_t, _spinlock_lock,   (dmosi_spinlock_t* lock) )
+{
+    dmosi_critical_state_t state = dmosi_critical_enter();
+    if (lock != NULL) {
+        while (dmosi_atomic_exchange_u32(&lock->locked, 1u, DMOSI_MEMORY_ORDER_ACQUIRE) != 0) {
+            // Spin on a plain load so waiting cores don't keep stealing the
+            // cache line from the holder
+            while (dmosi_atomic_load_u32(&lock->locked, DMOSI_MEMORY_ORDER_RELAXED) != 0) {
+            }
+        }
+    }
+    return state;
+}
+
+/**
+ * @brief Generic implementation of dmosi_spinlock_unlock
+ *
+ * @param lock Spinlock to release
+ * @param state State returned by the matching dmosi_spinlock_lock
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _spinlock_unlock, (dmosi_spinlock_t* lock, dmosi_critical_state_t state) )
+{
+    if (lock != NULL) {
+        dmosi_atomic_store_u32(&lock->locked, 0u, DMOSI_MEMORY_ORDER_RELEASE);
+    }
+    dmosi_critical_exit(state);
+}
+
 //==============================================================================
 //                              System Time API
 //==============================================================================
@@ -1218,12 +4160,17 @@ DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, uint32_t, _get_tick_count, (void) )
 /**
  * @brief DMOD Mutex_New implementation using DMOSI
  *
+ * Creates the mutex with the default attributes (see DMOSI_MUTEX_ATTR_DEFAULT),
+ * only changing whether it is recursive.
+ *
  * @param recursive Whether the mutex should be recursive
  * @return void* Created mutex handle (as a dmosi_mutex_t), NULL on failure
  */
 void* Dmod_Mutex_New(bool recursive)
 {
-    return (void*)dmosi_mutex_create(recursive);
+    dmosi_mutex_attr_t attr = DMOSI_MUTEX_ATTR_DEFAULT;
+    attr.recursive = recursive;
+    return (void*)dmosi_mutex_create_ex(&attr);
 }
 
 /**
@@ -1339,7 +4286,7 @@ void Dmod_Semaphore_Delete(void* Semaphore)
 const char* Dmod_GetCurrentModuleNameEx(const char* Default)
 {
     // Get the module name from the current thread's associated process
-    dmosi_process_t current_process = dmosi_process_current();
+    dmosi_process_t current_process = dmosi_process_current_cached();
     if (current_process != NULL) {
         // The foreground module reflects whichever context is currently executing within
         // this process (see dmosi_process_set_foreground_module), which is the correct
@@ -1370,7 +4317,7 @@ const char* Dmod_GetCurrentModuleNameEx(const char* Default)
  */
 Dmod_Context_t* Dmod_GetCurrentContext(void)
 {
-    dmosi_process_t current_process = dmosi_process_current();
+    dmosi_process_t current_process = dmosi_process_current_cached();
     if (current_process != NULL) {
         return dmosi_process_get_context(current_process);
     }
@@ -1425,6 +4372,42 @@ typedef struct {
     dmosi_process_t process;  // Process handle for this spawn
 } dmod_spawn_args_t;
 
+/**
+ * @brief Run a spawned module to completion in the calling thread
+ *
+ * @param spawn_args Module context, arguments and the process it runs in
+ * @return int Result of the module's main function
+ */
+static int dmod_spawn_run_module(dmod_spawn_args_t* spawn_args)
+{
+    // Run the module and get result
+    int result = Dmod_Run(spawn_args->context, spawn_args->argc, spawn_args->argv);
+
+    // Destroy the module's thread-local values now: their destructors are
+    // module code, gone once the context is unloaded below
+    dmosi_tls_thread_reset();
+
+    // This thread owns unloading the context: the caller that spawned us (see
+    // Dmod_SpawnModule/Dmod_RunModuleDetached) deliberately does not unload it
+    // itself, since Dmod_Unload(..., false) only unloads when the module isn't
+    // marked Running - and Dmod_Run() is what marks it Running, which only
+    // happens once this thread actually starts executing. Unloading from the
+    // caller right after spawning (before the scheduler necessarily gave this
+    // thread any time to run) would see Running still false and destroy the
+    // context out from under a module that hasn't run yet. By the time we get
+    // here, Dmod_Run() has already cleared Running back to false on its way out,
+    // so this unload is always safe.
+    Dmod_Unload(spawn_args->context, false);
+
+    // Dmod_Unload just freed the context - clear the process's link to it so
+    // Dmod_GetCurrentContext() can never hand back a dangling pointer if anything
+    // queries it for this process again before dmosi_process_destroy() runs (which
+    // happens much later, at reap time, from a different thread).
+    dmosi_process_set_context(spawn_args->process, NULL);
+
+    return result;
+}
+
 /**
  * @brief Thread entry function for spawned modules
  *
@@ -1436,26 +4419,7 @@ static void dmod_spawn_thread_entry(void* arg)
 {
     dmod_spawn_args_t* spawn_args = arg;
     if (spawn_args != NULL && spawn_args->context != NULL) {
-        // Run the module and get result
-        int result = Dmod_Run(spawn_args->context, spawn_args->argc, spawn_args->argv);
-
-        // This thread owns unloading the context: the caller that spawned us (see
-        // Dmod_SpawnModule/Dmod_RunModuleDetached) deliberately does not unload it
-        // itself, since Dmod_Unload(..., false) only unloads when the module isn't
-        // marked Running - and Dmod_Run() is what marks it Running, which only
-        // happens once this thread actually starts executing. Unloading from the
-        // caller right after spawning (before the scheduler necessarily gave this
-        // thread any time to run) would see Running still false and destroy the
-        // context out from under a module that hasn't run yet. By the time we get
-        // here, Dmod_Run() has already cleared Running back to false on its way out,
-        // so this unload is always safe.
-        Dmod_Unload(spawn_args->context, false);
-
-        // Dmod_Unload just freed the context - clear the process's link to it so
-        // Dmod_GetCurrentContext() can never hand back a dangling pointer if anything
-        // queries it for this process again before dmosi_process_destroy() runs (which
-        // happens much later, at reap time, from a different thread).
-        dmosi_process_set_context(spawn_args->process, NULL);
+        int result = dmod_spawn_run_module(spawn_args);
 
         // Free the structure before exiting (Exit never returns)
         Dmod_Free(spawn_args);
@@ -1521,6 +4485,360 @@ static int dmod_apply_stream_redirections(dmosi_process_t process, const char* m
     return 0;
 }
 
+/**
+ * @brief Thread stack size for a module needing @p module_stack_size bytes
+ *
+ * @param module_stack_size Stack size from the module header, 0 if not given
+ * @return size_t Stack size to create the module's thread with
+ */
+static size_t dmod_spawn_get_thread_stack_size(uint64_t module_stack_size)
+{
+    // Add overhead for thread/module startup
+    if (module_stack_size == 0) {
+        module_stack_size = DMOSI_DEFAULT_STACK_SIZE;
+    }
+    return (size_t)(module_stack_size + DMOSI_THREAD_STACK_OVERHEAD);
+}
+
+#if defined(DMOSI_ENABLE_SPAWN_POOL)
+/*
+ * Spawn pool: worker threads started by dmosi_spawn_pool_prewarm, each in a
+ * parking process of its own, waiting on a semaphore in an idle list per
+ * stack size class. A spawn still creates its process (it needs a fresh PID,
+ * parent and exit status) but takes an idle worker of its class and priority
+ * instead of allocating a thread, a stack and its spawn arguments. The worker
+ * moves into the new process with dmosi_process_set_current, runs the module,
+ * moves back to its parking process and terminates the module's process with
+ * dmosi_process_kill - so the module process ends up exactly as if its own
+ * thread had called Dmod_Exit.
+ *
+ * This relies on the backend to:
+ *  - move the calling thread into the given process in dmosi_process_set_current
+ *    (process lookups, module names and Dmod_Exit then follow the new process),
+ *  - let dmosi_process_kill terminate a process from a thread outside of it,
+ *  - run thread exit callbacks for threads killed along with their process.
+ *
+ * A module calling Dmod_Exit kills the worker with its process; the worker's
+ * exit callback then releases what the worker owned. The idle lists are
+ * protected by a spinlock, as they are only held to push or pop an entry.
+ *
+ * Per-thread state must not leak from one module into the next: the
+ * module's TLS values are destroyed before it is unloaded, and as
+ * dmosi has no call to restore a thread's priority, a worker whose priority
+ * the module changed is retired instead of parked - it ends its thread and
+ * is joined and freed by the next dmosi_spawn_pool_trim. Exit callbacks a
+ * module registers on its own thread are beyond dmosi's reach, so modules
+ * that may run on the pool have to unregister them before returning.
+ */
+
+/**
+ * @brief Smallest thread stack size class of the spawn pool, in bytes
+ */
+#ifndef DMOSI_SPAWN_POOL_MIN_STACK_SIZE
+#   define DMOSI_SPAWN_POOL_MIN_STACK_SIZE      2048
+#endif
+
+/**
+ * @brief Number of stack size classes, each twice as large as the previous one
+ */
+#ifndef DMOSI_SPAWN_POOL_CLASS_COUNT
+#   define DMOSI_SPAWN_POOL_CLASS_COUNT         8
+#endif
+
+/**
+ * @brief Parked spawn worker
+ */
+typedef struct dmod_spawn_worker {
+    struct dmod_spawn_worker*   next;           //!< Next idle worker of the same class
+    dmosi_thread_t              thread;         //!< Worker thread
+    dmosi_process_t             parking;        //!< Process the worker sits in while idle
+    dmosi_semaphore_t           wakeup;         //!< Posted to hand over a module or stop
+    dmosi_semaphore_t           started;        //!< Posted once the worker checked it can switch processes
+    dmosi_thread_exit_callback_handle_t exit_callback; //!< Cleanup if killed by a module
+    dmod_spawn_args_t           args;           //!< Module to run, NULL context to stop
+    size_t                      stack_class;    //!< Stack size class of the worker
+    int                         priority;       //!< Priority the worker was created with
+    int                         base_priority;  //!< Priority the backend reported when the worker started
+    bool                        busy;           //!< Whether the worker is running a module
+    bool                        usable;         //!< Whether dmosi_process_set_current works for the worker
+} dmod_spawn_worker_t;
+
+static dmosi_spinlock_t     s_spawn_pool_lock = DMOSI_SPINLOCK_INIT;            //!< Protects s_spawn_pool_idle
+static dmod_spawn_worker_t* s_spawn_pool_idle[DMOSI_SPAWN_POOL_CLASS_COUNT];    //!< Idle workers per class
+static dmod_spawn_worker_t* s_spawn_pool_retired;                               //!< Ended workers still to be joined
+
+/**
+ * @brief Stack size class of a thread stack size
+ *
+ * @return size_t Class index, DMOSI_SPAWN_POOL_CLASS_COUNT if too large for the pool
+ */
+static size_t dmod_spawn_pool_get_class(size_t stack_size)
+{
+    size_t class_index = 0;
+    while (class_index < DMOSI_SPAWN_POOL_CLASS_COUNT && ((size_t)DMOSI_SPAWN_POOL_MIN_STACK_SIZE << class_index) < stack_size) {
+        class_index++;
+    }
+    return class_index;
+}
+
+/**
+ * @brief Release the resources of a worker whose thread has ended
+ */
+static void dmod_spawn_pool_free_worker(dmod_spawn_worker_t* worker)
+{
+    dmosi_process_destroy(worker->parking);
+    dmosi_semaphore_destroy(worker->wakeup);
+    Dmod_Free(worker);
+}
+
+/**
+ * @brief Thread exit callback of a worker, cleaning up if a module killed it
+ */
+static void dmod_spawn_pool_worker_exit(dmosi_thread_t thread, void* arg)
+{
+    (void)thread;
+    dmod_spawn_worker_t* worker = arg;
+
+    // A worker stopped by dmosi_spawn_pool_trim is freed there, after joining
+    // it; only a worker that died inside a module (Dmod_Exit killed it along
+    // with the module's process, which now also reaps its thread) is freed here
+    if (worker->busy) {
+        dmod_spawn_pool_free_worker(worker);
+    }
+}
+
+/**
+ * @brief Put a worker on the idle list of its class
+ */
+static void dmod_spawn_pool_park(dmod_spawn_worker_t* worker)
+{
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_spawn_pool_lock);
+    worker->busy = false;
+    worker->next = s_spawn_pool_idle[worker->stack_class];
+    s_spawn_pool_idle[worker->stack_class] = worker;
+    dmosi_spinlock_unlock(&s_spawn_pool_lock, state);
+}
+
+/**
+ * @brief Put a worker that is about to end its thread on the retired list
+ */
+static void dmod_spawn_pool_retire(dmod_spawn_worker_t* worker)
+{
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_spawn_pool_lock);
+    worker->busy = false;
+    worker->next = s_spawn_pool_retired;
+    s_spawn_pool_retired = worker;
+    dmosi_spinlock_unlock(&s_spawn_pool_lock, state);
+}
+
+/**
+ * @brief Main loop of a spawn worker
+ *
+ * @param arg Pointer to the dmod_spawn_worker_t of this worker
+ */
+static void dmod_spawn_pool_worker_entry(void* arg)
+{
+    dmod_spawn_worker_t* worker = arg;
+    worker->base_priority = dmosi_thread_get_priority(NULL);
+
+    // Check the backend can move the worker between processes before any
+    // spawn is committed to it; dmosi_spawn_pool_prewarm waits for this
+    worker->usable = dmosi_process_set_current(worker->parking) == 0;
+    dmosi_process_invalidate_cached(NULL);
+    dmosi_semaphore_post(worker->started, 1);
+    if (!worker->usable) {
+        return;
+    }
+
+    while (dmosi_semaphore_wait(worker->wakeup, 1, -1) == 0 && worker->args.context != NULL) {
+        dmod_spawn_args_t* spawn_args = &worker->args;
+        int result;
+        if (dmosi_process_set_current(spawn_args->process) == 0) {
+            dmosi_process_invalidate_cached(NULL);
+            result = dmod_spawn_run_module(spawn_args);
+            dmosi_process_set_current(worker->parking);
+            dmosi_process_invalidate_cached(NULL);
+        } else {
+            DMOD_LOG_ERROR("Spawn pool worker failed to enter the process of module '%s'\n", Dmod_GetName(spawn_args->context));
+            Dmod_Unload(spawn_args->context, false);
+            dmosi_process_set_context(spawn_args->process, NULL);
+            result = -ENOSYS;
+        }
+
+        bool reusable = dmosi_thread_get_priority(NULL) == worker->base_priority;
+
+        // Park before terminating the module's process, so that whoever waits for it
+        // finds the worker idle again; worker->args may be reused from then on
+        dmosi_process_t process = spawn_args->process;
+        if (reusable) {
+            dmod_spawn_pool_park(worker);
+        } else {
+            dmod_spawn_pool_retire(worker);
+        }
+
+        // Terminate the module's process from outside, as Dmod_Exit would have from inside
+        dmosi_process_kill(process, result);
+        if (!reusable) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Hand a freshly created module process to an idle worker
+ *
+ * @param spawn_args Module context, arguments and the process to run it in
+ * @param stack_size Thread stack size the module needs
+ * @param priority Priority the module's thread would be created with
+ * @return bool true if a worker took the module, false if a thread must be created
+ */
+static bool dmod_spawn_pool_handoff(const dmod_spawn_args_t* spawn_args, size_t stack_size, int priority)
+{
+    size_t class_index = dmod_spawn_pool_get_class(stack_size);
+    if (class_index >= DMOSI_SPAWN_POOL_CLASS_COUNT) {
+        return false;
+    }
+
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_spawn_pool_lock);
+    dmod_spawn_worker_t** link = &s_spawn_pool_idle[class_index];
+    while (*link != NULL && (*link)->priority != priority) {
+        link = &(*link)->next;
+    }
+    dmod_spawn_worker_t* worker = *link;
+    if (worker != NULL) {
+        *link = worker->next;
+        worker->busy = true;
+    }
+    dmosi_spinlock_unlock(&s_spawn_pool_lock, state);
+
+    if (worker == NULL) {
+        return false;
+    }
+
+    worker->args = *spawn_args;
+    dmosi_semaphore_post(worker->wakeup, 1);
+    return true;
+}
+
+/**
+ * @brief DMOSI spawn pool prewarm implementation
+ *
+ * @param stack_size Module stack size the workers are sized for (0 = default)
+ * @param priority Priority of the workers (0 = default)
+ * @param count Number of workers to start
+ * @return int Number of workers started, negative error code on failure
+ */
+DMOD_INPUT_API_DECLARATION( dmosi, 1.0, int, _spawn_pool_prewarm, (size_t stack_size, int priority, size_t count) )
+{
+    size_t class_index = dmod_spawn_pool_get_class(dmod_spawn_get_thread_stack_size(stack_size));
+    if (class_index >= DMOSI_SPAWN_POOL_CLASS_COUNT) {
+        return -EINVAL;
+    }
+    if (priority == 0) {
+        priority = DMOSI_DEFAULT_PRIORITY;
+    }
+
+    dmosi_semaphore_t worker_started = dmosi_semaphore_create(0, 1);
+    if (worker_started == NULL) {
+        return -ENOMEM;
+    }
+
+    int started = 0;
+    int result  = -ENOMEM;
+    for (size_t i = 0; i < count; i++) {
+        dmod_spawn_worker_t* worker = Dmod_Malloc(sizeof(dmod_spawn_worker_t));
+        if (worker == NULL) {
+            break;
+        }
+        memset(worker, 0, sizeof(dmod_spawn_worker_t));
+        worker->stack_class = class_index;
+        worker->priority    = priority;
+        worker->busy        = true;     // until its thread is up and parked
+        worker->started     = worker_started;
+        worker->wakeup      = dmosi_semaphore_create(0, 1);
+        worker->parking     = dmosi_process_create("spawn_pool", NULL, NULL);
+        if (worker->wakeup != NULL && worker->parking != NULL) {
+            worker->thread = dmosi_thread_create(dmod_spawn_pool_worker_entry, worker, priority,
+                                                 (size_t)DMOSI_SPAWN_POOL_MIN_STACK_SIZE << class_index,
+                                                 "spawn_pool", worker->parking);
+        }
+        if (worker->thread == NULL) {
+            if (worker->parking != NULL) {
+                dmosi_process_destroy(worker->parking);
+            }
+            if (worker->wakeup != NULL) {
+                dmosi_semaphore_destroy(worker->wakeup);
+            }
+            Dmod_Free(worker);
+            break;
+        }
+
+        dmosi_semaphore_wait(worker_started, 1, -1);
+        if (!worker->usable) {
+            // The backend can't switch processes: spawns keep using threads of their own
+            dmosi_thread_join(worker->thread);
+            dmosi_thread_destroy(worker->thread);
+            dmod_spawn_pool_free_worker(worker);
+            result = -ENOSYS;
+            break;
+        }
+        worker->exit_callback = dmosi_thread_register_exit_callback(worker->thread, dmod_spawn_pool_worker_exit, worker);
+        dmod_spawn_pool_park(worker);
+        started++;
+    }
+    dmosi_semaphore_destroy(worker_started);
+
+    return (started == 0 && count > 0) ? result : started;
+}
+
+/**
+ * @brief DMOSI spawn pool trim implementation
+ *
+ * @return int Number of workers stopped
+ */
+DMOD_INPUT_API_DECLARATION( dmosi, 1.0, int, _spawn_pool_trim, (void) )
+{
+    dmod_spawn_worker_t* workers = NULL;
+
+    dmosi_critical_state_t state = dmosi_spinlock_lock(&s_spawn_pool_lock);
+    dmod_spawn_worker_t* retired = s_spawn_pool_retired;
+    s_spawn_pool_retired = NULL;
+    for (size_t class_index = 0; class_index < DMOSI_SPAWN_POOL_CLASS_COUNT; class_index++) {
+        while (s_spawn_pool_idle[class_index] != NULL) {
+            dmod_spawn_worker_t* worker = s_spawn_pool_idle[class_index];
+            s_spawn_pool_idle[class_index] = worker->next;
+            worker->next = workers;
+            workers = worker;
+        }
+    }
+    dmosi_spinlock_unlock(&s_spawn_pool_lock, state);
+
+    int stopped = 0;
+    while (workers != NULL) {
+        dmod_spawn_worker_t* worker = workers;
+        workers = worker->next;
+
+        worker->args.context = NULL;
+        dmosi_semaphore_post(worker->wakeup, 1);
+        dmosi_thread_join(worker->thread);
+        dmosi_thread_destroy(worker->thread);
+        dmod_spawn_pool_free_worker(worker);
+        stopped++;
+    }
+
+    // Workers retired after a module changed their priority have ended already
+    while (retired != NULL) {
+        dmod_spawn_worker_t* worker = retired;
+        retired = worker->next;
+
+        dmosi_thread_join(worker->thread);
+        dmosi_thread_destroy(worker->thread);
+        dmod_spawn_pool_free_worker(worker);
+    }
+    return stopped;
+}
+#endif // DMOSI_ENABLE_SPAWN_POOL
+
 /**
  * @brief Helper function to spawn a module in a new process/thread
  *
@@ -1571,6 +4889,28 @@ static Dmod_Pid_t dmod_spawn_module_internal(Dmod_Context_t* Context, int argc,
     // Get process ID
     dmosi_process_id_t pid = dmosi_process_get_id(new_process);
 
+    // Get stack size from Context header
+    size_t stack_size = dmod_spawn_get_thread_stack_size(Dmod_GetStackSize(Context));
+
+    // Inherit priority from current thread
+    int priority = dmosi_thread_get_priority(NULL);
+    if (priority == 0) {
+        priority = DMOSI_DEFAULT_PRIORITY;
+    }
+
+#if defined(DMOSI_ENABLE_SPAWN_POOL)
+    // Prefer a parked worker of the same stack size class and priority
+    dmod_spawn_args_t pooled_args = {
+        .context = Context,
+        .argc    = argc,
+        .argv    = argv,
+        .process = new_process,
+    };
+    if (dmod_spawn_pool_handoff(&pooled_args, stack_size, priority)) {
+        return (Dmod_Pid_t)pid;
+    }
+#endif
+
     // Allocate spawn args on heap using MallocEx for better tracking
     // Note: We create the process first to get the PID, then allocate spawn_args.
     // If allocation fails, we properly clean up the process before returning.
@@ -1586,19 +4926,6 @@ static Dmod_Pid_t dmod_spawn_module_internal(Dmod_Context_t* Context, int argc,
     spawn_args->argv = argv;
     spawn_args->process = new_process;
 
-    // Get stack size from Context header and add overhead for thread/module startup
-    uint64_t stack_size = Dmod_GetStackSize(Context);
-    if (stack_size == 0) {
-        stack_size = DMOSI_DEFAULT_STACK_SIZE;
-    }
-    stack_size += DMOSI_THREAD_STACK_OVERHEAD;
-
-    // Inherit priority from current thread
-    int priority = dmosi_thread_get_priority(NULL);
-    if (priority == 0) {
-        priority = DMOSI_DEFAULT_PRIORITY;
-    }
-
     // Create a thread to run the module
     // The thread name uses the module's name since the thread is part of the new process/module.
     // The module name is stored in the process and retrieved via dmosi_thread_get_module_name.
@@ -1606,7 +4933,7 @@ static Dmod_Pid_t dmod_spawn_module_internal(Dmod_Context_t* Context, int argc,
         dmod_spawn_thread_entry,
         spawn_args,
         priority,
-        (size_t)stack_size,
+        stack_size,
         module_name,  // Thread name: identifies the thread
         new_process   // Process: associate thread with the new process
     );
@@ -1675,7 +5002,7 @@ Dmod_Pid_t Dmod_RunDetached(Dmod_Context_t* Context, int argc, char* argv[], con
  */
 Dmod_Pid_t Dmod_GetCurrentPid(void)
 {
-    dmosi_process_t current_process = dmosi_process_current();
+    dmosi_process_t current_process = dmosi_process_current_cached();
     if (current_process == NULL) {
         return (Dmod_Pid_t)-ENOSYS;
     }
@@ -1855,14 +5182,14 @@ void* Dmod_LockStdio(void* StdHandle)
     dmosi_stream_index_t index;
     if (dmod_resolve_stream_index(StdHandle, &index)) {
         // Fault handlers set this before doing anything else (see Dmod_SetForceKernelWrite)
-        // specifically to skip dmosi_process_current() below - process/thread state may
+        // specifically to skip dmosi_process_current_cached() below - process/thread state may
         // already be corrupted in that context, and resolving it can fault a second time.
         // Returning NULL here routes the caller straight to its Dmod_WriteKernel fallback.
         if (Dmod_IsForceKernelWrite()) {
             return NULL;
         }
 
-        dmosi_process_t current_process = dmosi_process_current();
+        dmosi_process_t current_process = dmosi_process_current_cached();
         if (current_process == NULL) {
             return NULL;
         }
@@ -1896,7 +5223,7 @@ void Dmod_UnlockStdio(void* StdHandle)
 {
     dmosi_stream_index_t index;
     if (dmod_resolve_stream_index(StdHandle, &index)) {
-        dmosi_process_t current_process = dmosi_process_current();
+        dmosi_process_t current_process = dmosi_process_current_cached();
         if (current_process != NULL) {
             dmosi_process_unlock_stream(current_process, index);
         }
@@ -0,0 +1,131 @@
+/*
+ * Default (weak) implementations of the dmosi mutex API.
+ *
+ * These live in their own translation unit rather than in dmosi.c: the mutex
+ * profiler (DMOSI_ENABLE_MUTEX_PROFILING) hooks dmosi_mutex_lock/_unlock/
+ * _destroy with -Wl,--wrap, which only redirects references to a symbol that
+ * the referencing object file does not define itself. Keeping the
+ * definitions out of dmosi.c leaves its own mutex calls (Dmod_Mutex_Lock,
+ * the condition variable, barrier, work queue, task pool, ...) undefined
+ * there, so they are profiled like any other caller.
+ */
+#include <errno.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+//==============================================================================
+//                              MUTEX API
+//==============================================================================
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_create
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param recursive Whether the mutex should be recursive (unused)
+ * @return dmosi_mutex_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_mutex_t, _mutex_create,    (bool recursive) )
+{
+    return NULL;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_create_ex
+ *
+ * Overridden by the platform-specific dmosi backend. This default can only
+ * honour DMOSI_MUTEX_PROTOCOL_NONE, which it forwards to dmosi_mutex_create;
+ * the spin count is only a hint and is ignored.
+ *
+ * @param attr Mutex attributes, or NULL for DMOSI_MUTEX_ATTR_DEFAULT
+ * @return dmosi_mutex_t Result of dmosi_mutex_create, or NULL if a priority protocol was requested
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_mutex_t, _mutex_create_ex, (const dmosi_mutex_attr_t* attr) )
+{
+    static const dmosi_mutex_attr_t default_attr = DMOSI_MUTEX_ATTR_DEFAULT;
+    if (attr == NULL) {
+        attr = &default_attr;
+    }
+
+    if (attr->protocol != DMOSI_MUTEX_PROTOCOL_NONE) {
+        return NULL;
+    }
+    return dmosi_mutex_create(attr->recursive);
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_destroy
+ *
+ * Overridden by the platform-specific dmosi backend. This default is a no-op,
+ * used when no backend has been linked in.
+ *
+ * @param mutex Mutex handle to destroy (unused)
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, void, _mutex_destroy,   (dmosi_mutex_t mutex) )
+{
+    (void)mutex;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_lock
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param mutex Mutex handle to lock (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _mutex_lock,      (dmosi_mutex_t mutex) )
+{
+    (void)mutex;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_unlock
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param mutex Mutex handle to unlock (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _mutex_unlock,    (dmosi_mutex_t mutex) )
+{
+    (void)mutex;
+    return -ENOSYS;
+}
+
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_create_static
+ *
+ * Overridden by the platform-specific dmosi backend. This default is used
+ * when no backend has been linked in.
+ *
+ * @param recursive Whether the mutex should be recursive (unused)
+ * @param storage Control block storage (unused)
+ * @return dmosi_mutex_t Always NULL
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, dmosi_mutex_t, _mutex_create_static, (bool recursive, dmosi_mutex_storage_t* storage) )
+{
+    (void)recursive;
+    (void)storage;
+    return NULL;
+}
+
+#if !defined(DMOSI_ENABLE_MUTEX_PROFILING)
+/**
+ * @brief Default (weak) implementation of dmosi_mutex_profile_dump
+ *
+ * Used when dmosi is built without DMOSI_ENABLE_MUTEX_PROFILING; the
+ * profiling implementation lives in dmosi_mutex_profile.c.
+ *
+ * @param top_n Maximum number of entries to report (unused)
+ * @return int Always -ENOSYS
+ */
+DMOD_INPUT_WEAK_API_DECLARATION( dmosi, 1.0, int, _mutex_profile_dump, (size_t top_n) )
+{
+    (void)top_n;
+    return -ENOSYS;
+}
+#endif
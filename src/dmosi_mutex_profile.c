@@ -0,0 +1,406 @@
+/*
+ * Mutex contention profiler - only built with DMOSI_ENABLE_MUTEX_PROFILING.
+ *
+ * dmosi_mutex_lock/_unlock/_destroy are provided by the backend, so there is
+ * nothing in dmosi.c to hook them from. Instead, CMakeLists.txt links the
+ * final image with -Wl,--wrap for each of them. The linker only redirects
+ * references to a symbol from object files that do not define it, which
+ * covers modules (through dmosi_registrations.c), dmosi.c - whose weak
+ * mutex defaults are kept apart in dmosi_mutex.c for this reason - and the
+ * rest of the backend: their calls reach the __wrap_ functions below, which
+ * do their bookkeeping around a call to the real implementation (__real_).
+ * Calls the backend makes within the translation unit defining them are not
+ * seen. The backend doesn't need to know profiling is enabled.
+ *
+ * Bookkeeping uses fixed-size tables only - no heap and no lock of its own:
+ *  - a mutex slot per profiled mutex records its current owner, so a lock
+ *    attempt can tell it is contended before it blocks;
+ *  - a stats entry per (mutex, module of the locking thread) pair holds the
+ *    counters reported by dmosi_mutex_profile_dump. Destroying a mutex
+ *    retires its entries: they are still reported, but never matched by a
+ *    new mutex created at the same address, and are recycled once no free
+ *    entry is left.
+ * Slots and entries of a mutex are only ever claimed and updated while that
+ * very mutex is held, so the profiled mutex itself serializes all writers;
+ * only the owner field is read by other threads (atomically). The dump reads
+ * the counters without synchronization, so a report taken under load may mix
+ * values from neighbouring updates.
+ */
+#include <errno.h>
+#include <string.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+/**
+ * @brief Maximum number of mutexes tracked at once (destroyed mutexes free their slot)
+ */
+#ifndef DMOSI_MUTEX_PROFILE_MAX_MUTEXES
+#   define DMOSI_MUTEX_PROFILE_MAX_MUTEXES      64
+#endif
+
+/**
+ * @brief Maximum number of (mutex, module) pairs with their own counters
+ */
+#ifndef DMOSI_MUTEX_PROFILE_MAX_ENTRIES
+#   define DMOSI_MUTEX_PROFILE_MAX_ENTRIES      128
+#endif
+
+/**
+ * @brief Maximum number of threads inside the profiler at the same time
+ */
+#ifndef DMOSI_MUTEX_PROFILE_MAX_THREADS
+#   define DMOSI_MUTEX_PROFILE_MAX_THREADS      16
+#endif
+
+/**
+ * @brief Length of the module name buffer kept in each stats entry
+ */
+#ifndef DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN
+#   define DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN  32
+#endif
+
+int  __real_dmosi_mutex_lock(dmosi_mutex_t mutex);
+int  __real_dmosi_mutex_unlock(dmosi_mutex_t mutex);
+void __real_dmosi_mutex_destroy(dmosi_mutex_t mutex);
+
+int  __wrap_dmosi_mutex_lock(dmosi_mutex_t mutex);
+int  __wrap_dmosi_mutex_unlock(dmosi_mutex_t mutex);
+void __wrap_dmosi_mutex_destroy(dmosi_mutex_t mutex);
+
+/**
+ * @brief Life cycle of a stats entry
+ */
+enum {
+    ENTRY_FREE    = 0,  //!< Never used
+    ENTRY_LIVE    = 1,  //!< Counting for a mutex that still exists
+    ENTRY_RETIRED = 2,  //!< Mutex destroyed; still reported, may be recycled
+    ENTRY_CLAIMED = 3,  //!< Being set up for a mutex, becomes live once filled in
+};
+
+/**
+ * @brief Ownership state of a profiled mutex
+ */
+typedef struct {
+    void*          mutex;           //!< Mutex this slot tracks (dmosi_mutex_t), NULL if free
+    void*          owner;           //!< Thread currently holding the mutex (dmosi_thread_t), NULL if none
+    uint32_t       depth;           //!< Recursive lock depth of the owner
+    uint32_t       acquired_tick;   //!< Tick count at the owner's outermost lock
+    size_t         entry;           //!< Stats entry of the owner, or DMOSI_MUTEX_PROFILE_MAX_ENTRIES if none
+} mutex_slot_t;
+
+/**
+ * @brief Counters of one (mutex, module) pair
+ */
+typedef struct {
+    uint32_t      state;                                        //!< ENTRY_FREE, ENTRY_LIVE or ENTRY_RETIRED
+    void*         mutex;                                        //!< Mutex the counters belong to (dmosi_mutex_t)
+    char          module[DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN];  //!< Module of the locking thread
+    uint64_t      acquires;                                     //!< Number of successful outermost locks
+    uint64_t      contended;                                    //!< Number of locks that found the mutex held by another thread
+    uint64_t      total_wait_ticks;                             //!< Cumulative ticks spent waiting in lock
+    uint32_t      max_wait_ticks;                               //!< Longest single wait in lock, in ticks
+    uint32_t      max_hold_ticks;                               //!< Longest time the mutex was held, in ticks
+} mutex_entry_t;
+
+static mutex_slot_t   s_slots[DMOSI_MUTEX_PROFILE_MAX_MUTEXES];
+static mutex_entry_t  s_entries[DMOSI_MUTEX_PROFILE_MAX_ENTRIES];
+static void*          s_busy_threads[DMOSI_MUTEX_PROFILE_MAX_THREADS];
+static uint32_t       s_dropped;
+
+/**
+ * @brief Whether the calling thread is inside the profiler
+ *
+ * Resolving the module name calls into the backend, which may itself lock a
+ * dmosi mutex - and so re-enter __wrap_dmosi_mutex_lock. Such nested locks
+ * are passed straight to the backend instead of being profiled.
+ *
+ * @param self Calling thread
+ */
+static bool profiler_inside(dmosi_thread_t self)
+{
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_THREADS; i++) {
+        if (dmosi_atomic_load_ptr(&s_busy_threads[i], DMOSI_MEMORY_ORDER_ACQUIRE) == self) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Mark the calling thread as being inside the profiler
+ *
+ * Only held around the bookkeeping that may re-enter the profiler, never
+ * while blocked in the real lock, so the table only fills up when that many
+ * threads do their bookkeeping at the very same time.
+ *
+ * @param self Calling thread
+ * @param index Set to the claimed busy-table index
+ * @return bool false if the table is full (counted as dropped)
+ */
+static bool profiler_enter(dmosi_thread_t self, size_t* index)
+{
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_THREADS; i++) {
+        void* expected = NULL;
+        if (dmosi_atomic_compare_exchange_ptr(&s_busy_threads[i], &expected, self, DMOSI_MEMORY_ORDER_ACQ_REL, DMOSI_MEMORY_ORDER_RELAXED)) {
+            *index = i;
+            return true;
+        }
+    }
+    dmosi_atomic_fetch_add_u32(&s_dropped, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    return false;
+}
+
+/**
+ * @brief Release a busy-table index claimed with profiler_enter
+ */
+static void profiler_leave(size_t index)
+{
+    dmosi_atomic_store_ptr(&s_busy_threads[index], NULL, DMOSI_MEMORY_ORDER_RELEASE);
+}
+
+/**
+ * @brief Find the slot tracking @p mutex, optionally claiming a free one
+ *
+ * Claiming must only be done while holding @p mutex, which guarantees no
+ * other thread claims a second slot for it at the same time.
+ */
+static mutex_slot_t* find_slot(dmosi_mutex_t mutex, bool claim)
+{
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_MUTEXES; i++) {
+        if (dmosi_atomic_load_ptr(&s_slots[i].mutex, DMOSI_MEMORY_ORDER_ACQUIRE) == mutex) {
+            return &s_slots[i];
+        }
+    }
+    if (!claim) {
+        return NULL;
+    }
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_MUTEXES; i++) {
+        void* expected = NULL;
+        if (dmosi_atomic_compare_exchange_ptr(&s_slots[i].mutex, &expected, mutex, DMOSI_MEMORY_ORDER_ACQ_REL, DMOSI_MEMORY_ORDER_RELAXED)) {
+            s_slots[i].owner = NULL;
+            s_slots[i].depth = 0;
+            s_slots[i].entry = DMOSI_MUTEX_PROFILE_MAX_ENTRIES;
+            return &s_slots[i];
+        }
+    }
+    dmosi_atomic_fetch_add_u32(&s_dropped, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    return NULL;
+}
+
+/**
+ * @brief Claim the first entry found in state @p from, marking it ENTRY_CLAIMED
+ *
+ * @return size_t Index of the claimed entry, DMOSI_MUTEX_PROFILE_MAX_ENTRIES if none
+ */
+static size_t claim_entry(uint32_t from)
+{
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_ENTRIES; i++) {
+        uint32_t expected = from;
+        if (dmosi_atomic_compare_exchange_u32(&s_entries[i].state, &expected, ENTRY_CLAIMED, DMOSI_MEMORY_ORDER_ACQ_REL, DMOSI_MEMORY_ORDER_RELAXED)) {
+            return i;
+        }
+    }
+    return DMOSI_MUTEX_PROFILE_MAX_ENTRIES;
+}
+
+/**
+ * @brief Find or claim the stats entry of a (mutex, module) pair - only while holding @p mutex
+ */
+static size_t find_entry(dmosi_mutex_t mutex, const char* module)
+{
+    if (module == NULL) {
+        module = "?";
+    }
+
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_ENTRIES; i++) {
+        if (dmosi_atomic_load_u32(&s_entries[i].state, DMOSI_MEMORY_ORDER_ACQUIRE) == ENTRY_LIVE
+         && dmosi_atomic_load_ptr(&s_entries[i].mutex, DMOSI_MEMORY_ORDER_RELAXED) == mutex
+         && strncmp(s_entries[i].module, module, DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN - 1) == 0) {
+            return i;
+        }
+    }
+
+    // Prefer a never used entry, so retired ones stay in the report as long as possible
+    size_t index = claim_entry(ENTRY_FREE);
+    if (index == DMOSI_MUTEX_PROFILE_MAX_ENTRIES) {
+        index = claim_entry(ENTRY_RETIRED);
+    }
+    if (index < DMOSI_MUTEX_PROFILE_MAX_ENTRIES) {
+        mutex_entry_t* entry    = &s_entries[index];
+        dmosi_atomic_store_ptr(&entry->mutex, mutex, DMOSI_MEMORY_ORDER_RELAXED);
+        strncpy(entry->module, module, DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN - 1);
+        entry->module[DMOSI_MUTEX_PROFILE_MODULE_NAME_LEN - 1] = '\0';
+        entry->acquires         = 0;
+        entry->contended        = 0;
+        entry->total_wait_ticks = 0;
+        entry->max_wait_ticks   = 0;
+        entry->max_hold_ticks   = 0;
+        dmosi_atomic_store_u32(&entry->state, ENTRY_LIVE, DMOSI_MEMORY_ORDER_RELEASE);
+        return index;
+    }
+    dmosi_atomic_fetch_add_u32(&s_dropped, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    return DMOSI_MUTEX_PROFILE_MAX_ENTRIES;
+}
+
+/**
+ * @brief Profiling wrapper of dmosi_mutex_lock
+ */
+int __wrap_dmosi_mutex_lock(dmosi_mutex_t mutex)
+{
+    dmosi_thread_t self = dmosi_thread_current();
+    if (mutex == NULL || self == NULL || profiler_inside(self)) {
+        return __real_dmosi_mutex_lock(mutex);
+    }
+
+    // The mutex has no slot yet on its very first lock; that one lock is
+    // then simply never counted as contended.
+    mutex_slot_t* slot = find_slot(mutex, false);
+    dmosi_thread_t owner = (slot != NULL) ? dmosi_atomic_load_ptr(&slot->owner, DMOSI_MEMORY_ORDER_ACQUIRE) : NULL;
+    bool contended = (owner != NULL && owner != self);
+
+    uint32_t start = dmosi_get_tick_count();
+    int result = __real_dmosi_mutex_lock(mutex);
+    uint32_t now = dmosi_get_tick_count();
+
+    if (result == 0) {
+        if (slot == NULL) {
+            slot = find_slot(mutex, true);
+        }
+        if (slot != NULL) {
+            if (slot->owner == self) {
+                // Recursive re-lock: the outermost lock already accounted for it
+                slot->depth++;
+            } else {
+                // Ownership is tracked even when the table is full, so
+                // later waiters still see the mutex as contended
+                size_t index = DMOSI_MUTEX_PROFILE_MAX_ENTRIES;
+                size_t busy_index;
+                if (profiler_enter(self, &busy_index)) {
+                    index = find_entry(mutex, dmosi_thread_get_module_name(NULL));
+                    profiler_leave(busy_index);
+                }
+                if (index < DMOSI_MUTEX_PROFILE_MAX_ENTRIES) {
+                    mutex_entry_t* entry = &s_entries[index];
+                    uint32_t wait_ticks = now - start;
+                    entry->acquires++;
+                    entry->contended        += contended ? 1 : 0;
+                    entry->total_wait_ticks += wait_ticks;
+                    if (wait_ticks > entry->max_wait_ticks) {
+                        entry->max_wait_ticks = wait_ticks;
+                    }
+                }
+                slot->entry         = index;
+                slot->depth         = 1;
+                slot->acquired_tick = now;
+                dmosi_atomic_store_ptr(&slot->owner, self, DMOSI_MEMORY_ORDER_RELEASE);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Profiling wrapper of dmosi_mutex_unlock
+ */
+int __wrap_dmosi_mutex_unlock(dmosi_mutex_t mutex)
+{
+    mutex_slot_t* slot = (mutex != NULL) ? find_slot(mutex, false) : NULL;
+    if (slot != NULL && slot->owner != NULL && slot->owner == dmosi_thread_current()) {
+        if (--slot->depth == 0) {
+            if (slot->entry < DMOSI_MUTEX_PROFILE_MAX_ENTRIES) {
+                mutex_entry_t* entry = &s_entries[slot->entry];
+                uint32_t hold_ticks = dmosi_get_tick_count() - slot->acquired_tick;
+                if (hold_ticks > entry->max_hold_ticks) {
+                    entry->max_hold_ticks = hold_ticks;
+                }
+            }
+            dmosi_atomic_store_ptr(&slot->owner, NULL, DMOSI_MEMORY_ORDER_RELEASE);
+        }
+    }
+    return __real_dmosi_mutex_unlock(mutex);
+}
+
+/**
+ * @brief Profiling wrapper of dmosi_mutex_destroy
+ *
+ * Frees the mutex's slot for reuse and retires its stats entries, so they
+ * still show up in the report but are not merged with a later mutex that
+ * happens to be allocated at the same address.
+ */
+void __wrap_dmosi_mutex_destroy(dmosi_mutex_t mutex)
+{
+    // Only this mutex's own destroy moves its live entries on, and nothing can
+    // claim a new entry for it meanwhile, so a live entry seen here stays put
+    for (size_t i = 0; mutex != NULL && i < DMOSI_MUTEX_PROFILE_MAX_ENTRIES; i++) {
+        if (dmosi_atomic_load_u32(&s_entries[i].state, DMOSI_MEMORY_ORDER_ACQUIRE) == ENTRY_LIVE
+         && dmosi_atomic_load_ptr(&s_entries[i].mutex, DMOSI_MEMORY_ORDER_RELAXED) == mutex) {
+            dmosi_atomic_store_u32(&s_entries[i].state, ENTRY_RETIRED, DMOSI_MEMORY_ORDER_RELEASE);
+        }
+    }
+    mutex_slot_t* slot = (mutex != NULL) ? find_slot(mutex, false) : NULL;
+    if (slot != NULL) {
+        dmosi_atomic_store_ptr(&slot->owner, NULL, DMOSI_MEMORY_ORDER_RELAXED);
+        dmosi_atomic_store_ptr(&slot->mutex, NULL, DMOSI_MEMORY_ORDER_RELEASE);
+    }
+    __real_dmosi_mutex_destroy(mutex);
+}
+
+/**
+ * @brief Profiling implementation of dmosi_mutex_profile_dump
+ *
+ * Entries are ranked by cumulative wait time, then by contended count.
+ * Times are in ticks of dmosi_get_tick_count.
+ *
+ * @param top_n Maximum number of entries to report (0 = all)
+ * @return int Number of entries reported
+ */
+DMOD_INPUT_API_DECLARATION( dmosi, 1.0, int, _mutex_profile_dump, (size_t top_n) )
+{
+    bool reported[DMOSI_MUTEX_PROFILE_MAX_ENTRIES] = { false };
+
+    size_t used = 0;
+    for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_ENTRIES; i++) {
+        uint32_t state = dmosi_atomic_load_u32(&s_entries[i].state, DMOSI_MEMORY_ORDER_ACQUIRE);
+        if (state == ENTRY_LIVE || state == ENTRY_RETIRED) {
+            used++;
+        }
+    }
+    if (top_n == 0 || top_n > used) {
+        top_n = used;
+    }
+
+    DMOD_LOG_INFO("dmosi mutex profile: top %zu of %zu (mutex, module) entries, %lu dropped\n",
+                  top_n, used, (unsigned long)dmosi_atomic_load_u32(&s_dropped, DMOSI_MEMORY_ORDER_RELAXED));
+
+    int count = 0;
+    for (size_t n = 0; n < top_n; n++) {
+        const mutex_entry_t* best = NULL;
+        size_t best_index = 0;
+        for (size_t i = 0; i < DMOSI_MUTEX_PROFILE_MAX_ENTRIES; i++) {
+            const mutex_entry_t* entry = &s_entries[i];
+            uint32_t state = dmosi_atomic_load_u32(&entry->state, DMOSI_MEMORY_ORDER_ACQUIRE);
+            if (reported[i] || (state != ENTRY_LIVE && state != ENTRY_RETIRED)) {
+                continue;
+            }
+            if (best == NULL
+             || entry->total_wait_ticks > best->total_wait_ticks
+             || (entry->total_wait_ticks == best->total_wait_ticks && entry->contended > best->contended)) {
+                best = entry;
+                best_index = i;
+            }
+        }
+        if (best == NULL) {
+            break;
+        }
+        reported[best_index] = true;
+
+        bool retired = dmosi_atomic_load_u32(&best->state, DMOSI_MEMORY_ORDER_RELAXED) == ENTRY_RETIRED;
+        DMOD_LOG_INFO("  %p %-16s acquires %llu contended %llu wait %llu ticks (max %lu ticks) hold max %lu ticks%s\n",
+                      dmosi_atomic_load_ptr(&best->mutex, DMOSI_MEMORY_ORDER_RELAXED), best->module,
+                      (unsigned long long)best->acquires, (unsigned long long)best->contended,
+                      (unsigned long long)best->total_wait_ticks, (unsigned long)best->max_wait_ticks,
+                      (unsigned long)best->max_hold_ticks, retired ? " (destroyed)" : "");
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,80 @@
+/*
+ * Cost of dmosi_process_current_cached against dmosi_process_current.
+ *
+ * The DMOD stdio, logging and context bridges look the current process up
+ * several times per log line. This runs both lookups in a loop on a thread
+ * that belongs to a process and prints the time per call. The test
+ * backend's dmosi_process_current takes a lock, like a backend whose threads
+ * can move between processes; with DMOSI_ENABLE_PROCESS_CACHE the cached
+ * call only reads the thread's TLS slot. Not part of the test suite: the
+ * numbers depend on the host, so run it by hand.
+ *
+ * Usage: bench_process_cache [calls]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+#define BENCH_DEFAULT_CALLS     10000000
+
+static int      s_process;
+static long     s_calls;
+static double   s_current_ns;
+static double   s_cached_ns;
+static int      s_failures;
+
+/**
+ * @brief Monotonic time in nanoseconds - finer than dmosi_get_tick_count
+ */
+static double bench_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static void bench_thread(void* arg)
+{
+    (void)arg;
+    dmosi_process_t expected = (dmosi_process_t)&s_process;
+
+    double start = bench_now_ns();
+    for (long i = 0; i < s_calls; i++) {
+        s_failures += (dmosi_process_current() != expected);
+    }
+    s_current_ns = (bench_now_ns() - start) / s_calls;
+
+    start = bench_now_ns();
+    for (long i = 0; i < s_calls; i++) {
+        s_failures += (dmosi_process_current_cached() != expected);
+    }
+    s_cached_ns = (bench_now_ns() - start) / s_calls;
+}
+
+int main(int argc, char* argv[])
+{
+    s_calls = (argc > 1) ? atol(argv[1]) : BENCH_DEFAULT_CALLS;
+    if (s_calls < 1) {
+        printf("usage: %s [calls]\n", argv[0]);
+        return 1;
+    }
+
+    dmosi_thread_t thread = dmosi_thread_create(bench_thread, NULL, 0, 0, "bench", (dmosi_process_t)&s_process);
+    if (thread == NULL) {
+        printf("FAIL: could not create thread\n");
+        return 1;
+    }
+    dmosi_thread_join(thread);
+    dmosi_thread_destroy(thread);
+    if (s_failures != 0) {
+        printf("FAIL: wrong process returned %d times\n", s_failures);
+        return 1;
+    }
+
+    printf("%ld calls each\n", s_calls);
+    printf("dmosi_process_current        %8.1f ns/call\n", s_current_ns);
+    printf("dmosi_process_current_cached %8.1f ns/call\n", s_cached_ns);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Throughput benchmark of the generic dmosi task pool.
+ *
+ * Runs the same fork-join workload - a recursive Fibonacci whose subproblems
+ * below a cutoff are computed serially - on pools of 1, 2, 4, ... workers up
+ * to the number of cores, and prints the tasks completed per second and the
+ * speedup over a single worker. Not part of the test suite: the numbers
+ * depend on the host, so run it by hand.
+ *
+ * Usage: bench_task_pool [n [cutoff [repeats [max_workers]]]]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+#define BENCH_DEFAULT_N         36
+#define BENCH_DEFAULT_CUTOFF    20
+#define BENCH_DEFAULT_REPEATS   3
+
+/**
+ * @brief One Fibonacci subproblem and its result
+ */
+typedef struct {
+    int         n;
+    uint64_t    result;
+} bench_fib_t;
+
+static dmosi_task_pool_t    s_pool;
+static int                  s_cutoff;
+static uint32_t             s_tasks;    //!< Tasks spawned during the current run
+
+/**
+ * @brief Serial Fibonacci, the work done by a leaf task
+ */
+static uint64_t bench_fib_serial(int n)
+{
+    return (n < 2) ? (uint64_t)n : bench_fib_serial(n - 1) + bench_fib_serial(n - 2);
+}
+
+/**
+ * @brief Fibonacci task: spawns one half as a child and computes the other itself
+ */
+static void bench_fib_task(dmosi_task_t self, void* arg)
+{
+    bench_fib_t* fib = arg;
+    if (fib->n <= s_cutoff) {
+        fib->result = bench_fib_serial(fib->n);
+        return;
+    }
+
+    bench_fib_t left  = { fib->n - 1, 0 };
+    bench_fib_t right = { fib->n - 2, 0 };
+    dmosi_task_t child = dmosi_task_spawn(s_pool, self, bench_fib_task, &left);
+    if (child == NULL) {
+        bench_fib_task(self, &left);
+    } else {
+        dmosi_atomic_fetch_add_u32(&s_tasks, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    }
+    bench_fib_task(self, &right);
+    if (child != NULL) {
+        dmosi_task_wait(child, -1);
+    }
+    fib->result = left.result + right.result;
+}
+
+/**
+ * @brief Run the workload on a pool of @p workers workers
+ *
+ * @return Best time of @p repeats runs in milliseconds, 0 on failure
+ */
+static uint32_t bench_run(uint32_t workers, int n, int repeats, uint64_t* result)
+{
+    s_pool = dmosi_task_pool_create(workers, 0, 0, "bench");
+    if (s_pool == NULL) {
+        printf("could not create a pool of %u workers\n", (unsigned)workers);
+        return 0;
+    }
+
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < repeats; i++) {
+        bench_fib_t fib = { n, 0 };
+        s_tasks = 1;
+        uint32_t start = dmosi_get_tick_count();
+        dmosi_task_t root = dmosi_task_spawn(s_pool, NULL, bench_fib_task, &fib);
+        if (root == NULL || dmosi_task_wait(root, -1) != 0) {
+            printf("could not run the workload on %u workers\n", (unsigned)workers);
+            best = 0;
+            break;
+        }
+        uint32_t elapsed = dmosi_get_tick_count() - start;
+        elapsed = (elapsed == 0) ? 1 : elapsed;
+        best = (elapsed < best) ? elapsed : best;
+        *result = fib.result;
+    }
+
+    dmosi_task_pool_destroy(s_pool);
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    int n       = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_N;
+    s_cutoff    = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_CUTOFF;
+    int repeats = (argc > 3) ? atoi(argv[3]) : BENCH_DEFAULT_REPEATS;
+    int cores   = (argc > 4) ? atoi(argv[4]) : (int)dmosi_get_core_count();
+    if (n < 0 || s_cutoff < 1 || repeats < 1 || cores < 1) {
+        printf("usage: %s [n [cutoff [repeats [max_workers]]]]\n", argv[0]);
+        return 1;
+    }
+
+    printf("fib(%d), cutoff %d, best of %d runs, up to %d workers\n", n, s_cutoff, repeats, cores);
+    printf("%8s %10s %10s %14s %8s\n", "workers", "ms", "tasks", "tasks/s", "speedup");
+
+    uint64_t expected  = bench_fib_serial(n);
+    uint32_t single_ms = 0;
+    for (uint32_t workers = 1; ; workers = (workers * 2 < (uint32_t)cores) ? workers * 2 : (uint32_t)cores) {
+        uint64_t result = 0;
+        uint32_t ms = bench_run(workers, n, repeats, &result);
+        if (ms == 0 || result != expected) {
+            printf("FAIL: %u workers\n", (unsigned)workers);
+            return 1;
+        }
+        if (workers == 1) {
+            single_ms = ms;
+        }
+        printf("%8u %10u %10u %14.0f %8.2f\n", (unsigned)workers, (unsigned)ms, (unsigned)s_tasks,
+               s_tasks * 1000.0 / ms, (double)single_ms / ms);
+        if (workers >= (uint32_t)cores) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+/*
+ * Minimal POSIX backend for the dmosi tests.
+ *
+ * Provides just the kernel objects the generic implementations in dmosi.c
+ * are built on - mutexes, semaphores, threads, thread-local slots, thread
+ * exit callbacks, the current process and the tick count - on top of
+ * pthreads, plus the Dmod_Malloc/Dmod_Free that dmosi.c allocates with.
+ * Everything else keeps dmosi.c's weak defaults. The tests build dmosi.c with
+ * DMOSI_DONT_IMPLEMENT_DMOD_API, so no DMOD core is needed either.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+/**
+ * @brief Mutex of the test backend
+ */
+struct dmosi_mutex {
+    pthread_mutex_t mutex;
+};
+
+/**
+ * @brief Counting semaphore of the test backend
+ */
+struct dmosi_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+    uint32_t        count;
+    uint32_t        max_count;
+};
+
+/**
+ * @brief Thread control block of the test backend
+ */
+struct dmosi_thread {
+    pthread_t                       thread;
+    dmosi_thread_entry_t            entry;
+    void*                           arg;
+    int                             priority;
+    dmosi_process_t                 process;
+    void*                           tls_slots[DMOSI_TLS_SLOT_COUNT];
+    dmosi_thread_exit_callback_t    exit_callback;
+    void*                           exit_callback_arg;
+};
+
+static __thread struct dmosi_thread* s_current_thread;
+
+/**
+ * @brief Protects the process of every thread, as a backend moving threads between processes would
+ */
+static pthread_mutex_t s_process_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void* Dmod_Malloc(size_t Size)
+{
+    return malloc(Size);
+}
+
+void Dmod_Free(void* Ptr)
+{
+    free(Ptr);
+}
+
+//==============================================================================
+//                              System
+//==============================================================================
+uint32_t dmosi_get_tick_count(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000u + now.tv_nsec / 1000000);
+}
+
+uint32_t dmosi_get_core_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1u;
+}
+
+/**
+ * @brief Absolute CLOCK_REALTIME deadline @p timeout_ms from now
+ */
+static struct timespec test_deadline(int32_t timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec  += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+//==============================================================================
+//                              Mutex
+//==============================================================================
+dmosi_mutex_t dmosi_mutex_create(bool recursive)
+{
+    struct dmosi_mutex* mutex = malloc(sizeof(struct dmosi_mutex));
+    if (mutex == NULL) {
+        return NULL;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    if (recursive) {
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    }
+    pthread_mutex_init(&mutex->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+
+void dmosi_mutex_destroy(dmosi_mutex_t mutex)
+{
+    pthread_mutex_destroy(&mutex->mutex);
+    free(mutex);
+}
+
+int dmosi_mutex_lock(dmosi_mutex_t mutex)
+{
+    return -pthread_mutex_lock(&mutex->mutex);
+}
+
+int dmosi_mutex_unlock(dmosi_mutex_t mutex)
+{
+    return -pthread_mutex_unlock(&mutex->mutex);
+}
+
+//==============================================================================
+//                              Semaphore
+//==============================================================================
+dmosi_semaphore_t dmosi_semaphore_create(uint32_t initial_count, uint32_t max_count)
+{
+    struct dmosi_semaphore* semaphore = malloc(sizeof(struct dmosi_semaphore));
+    if (semaphore == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->changed, NULL);
+    semaphore->count     = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+void dmosi_semaphore_destroy(dmosi_semaphore_t semaphore)
+{
+    pthread_cond_destroy(&semaphore->changed);
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+int dmosi_semaphore_wait(dmosi_semaphore_t semaphore, uint32_t count, int32_t timeout_ms)
+{
+    struct timespec deadline = test_deadline(timeout_ms > 0 ? timeout_ms : 0);
+    int result = 0;
+
+    pthread_mutex_lock(&semaphore->lock);
+    while (semaphore->count < count && result == 0) {
+        if (timeout_ms == 0) {
+            result = -ETIMEDOUT;
+        } else if (timeout_ms < 0) {
+            pthread_cond_wait(&semaphore->changed, &semaphore->lock);
+        } else if (pthread_cond_timedwait(&semaphore->changed, &semaphore->lock, &deadline) == ETIMEDOUT) {
+            result = (semaphore->count < count) ? -ETIMEDOUT : 0;
+        }
+    }
+    if (result == 0) {
+        semaphore->count -= count;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return result;
+}
+
+int dmosi_semaphore_post(dmosi_semaphore_t semaphore, uint32_t count)
+{
+    int result = 0;
+    pthread_mutex_lock(&semaphore->lock);
+    if (count > semaphore->max_count - semaphore->count) {
+        result = -EOVERFLOW;
+    } else {
+        semaphore->count += count;
+        pthread_cond_broadcast(&semaphore->changed);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return result;
+}
+
+//==============================================================================
+//                              Thread
+//==============================================================================
+/**
+ * @brief pthread entry running a dmosi thread and its exit callback
+ */
+static void* test_thread_entry(void* arg)
+{
+    struct dmosi_thread* thread = arg;
+    s_current_thread = thread;
+    thread->entry(thread->arg);
+    if (thread->exit_callback != NULL) {
+        thread->exit_callback(thread, thread->exit_callback_arg);
+    }
+    return NULL;
+}
+
+dmosi_thread_t dmosi_thread_create(dmosi_thread_entry_t entry, void* arg, int priority, size_t stack_size, const char* name, dmosi_process_t process)
+{
+    (void)stack_size;
+    (void)name;
+
+    struct dmosi_thread* thread = calloc(1, sizeof(struct dmosi_thread));
+    if (thread == NULL) {
+        return NULL;
+    }
+    thread->entry    = entry;
+    thread->arg      = arg;
+    thread->priority = priority;
+    thread->process  = process;
+    if (pthread_create(&thread->thread, NULL, test_thread_entry, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+int dmosi_thread_join(dmosi_thread_t thread)
+{
+    return -pthread_join(thread->thread, NULL);
+}
+
+void dmosi_thread_destroy(dmosi_thread_t thread)
+{
+    free(thread);
+}
+
+dmosi_thread_t dmosi_thread_current(void)
+{
+    if (s_current_thread == NULL) {
+        // A thread not created through dmosi, such as the test's main thread
+        s_current_thread = calloc(1, sizeof(struct dmosi_thread));
+        if (s_current_thread != NULL) {
+            s_current_thread->thread = pthread_self();
+        }
+    }
+    return s_current_thread;
+}
+
+void dmosi_thread_sleep(uint32_t ms)
+{
+    usleep(ms * 1000u);
+}
+
+int dmosi_thread_get_priority(dmosi_thread_t thread)
+{
+    if (thread == NULL) {
+        thread = dmosi_thread_current();
+    }
+    return thread->priority;
+}
+
+void** dmosi_thread_get_tls_slots(dmosi_thread_t thread)
+{
+    if (thread == NULL) {
+        thread = dmosi_thread_current();
+    }
+    return (thread != NULL) ? thread->tls_slots : NULL;
+}
+
+dmosi_thread_exit_callback_handle_t dmosi_thread_register_exit_callback(dmosi_thread_t thread, dmosi_thread_exit_callback_t callback, void* arg)
+{
+    // One callback per thread is all dmosi.c registers
+    if (thread == NULL || thread->exit_callback != NULL) {
+        return NULL;
+    }
+    thread->exit_callback     = callback;
+    thread->exit_callback_arg = arg;
+    return (dmosi_thread_exit_callback_handle_t)thread;
+}
+
+int dmosi_thread_unregister_exit_callback(dmosi_thread_t thread, dmosi_thread_exit_callback_handle_t handle)
+{
+    if (thread == NULL || handle != (dmosi_thread_exit_callback_handle_t)thread) {
+        return -EINVAL;
+    }
+    thread->exit_callback = NULL;
+    return 0;
+}
+
+//==============================================================================
+//                              Process
+//==============================================================================
+dmosi_process_t dmosi_process_current(void)
+{
+    struct dmosi_thread* thread = dmosi_thread_current();
+    pthread_mutex_lock(&s_process_lock);
+    dmosi_process_t process = (thread != NULL) ? thread->process : NULL;
+    pthread_mutex_unlock(&s_process_lock);
+    return process;
+}
+
+int dmosi_process_set_current(dmosi_process_t process)
+{
+    struct dmosi_thread* thread = dmosi_thread_current();
+    if (thread == NULL) {
+        return -ENOMEM;
+    }
+    pthread_mutex_lock(&s_process_lock);
+    thread->process = process;
+    pthread_mutex_unlock(&s_process_lock);
+    dmosi_process_invalidate_cached(NULL);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Tests of the generic dmosi_cond_t implementation.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+#define WAITERS     8
+#define ROUNDS      200
+
+static dmosi_mutex_t s_mutex;
+static dmosi_cond_t  s_cond;
+static uint32_t      s_generation;  //!< Bumped by every broadcast
+static uint32_t      s_waiting;     //!< Threads that entered the first wait of this round
+static uint32_t      s_woken;       //!< Threads released from the first wait of this round
+static uint32_t      s_failures;
+
+/**
+ * @brief Waits for one broadcast, then immediately waits for the next one
+ *
+ * The second wait starts while the first broadcast is still waking the
+ * other waiters, so it must not take a wakeup meant for one of them.
+ */
+static void rewaiting_thread(void* arg)
+{
+    (void)arg;
+    for (int round = 0; round < ROUNDS; round++) {
+        dmosi_mutex_lock(s_mutex);
+        if (s_failures != 0) {
+            dmosi_mutex_unlock(s_mutex);
+            break;
+        }
+        uint32_t generation = s_generation;
+        s_waiting++;
+        while (s_generation == generation) {
+            if (dmosi_cond_wait(s_cond, s_mutex, 1000) == -ETIMEDOUT && s_generation == generation) {
+                // The broadcast's wakeup was taken by someone else
+                s_failures++;
+                break;
+            }
+        }
+        s_woken++;
+        generation++;
+        while (s_generation == generation) {
+            if (dmosi_cond_wait(s_cond, s_mutex, 1000) == -ETIMEDOUT && s_generation == generation) {
+                s_failures++;
+                break;
+            }
+        }
+        dmosi_mutex_unlock(s_mutex);
+    }
+}
+
+/**
+ * @brief Wait until @p counter reaches @p value, with s_mutex held on return
+ */
+static bool wait_for_count(uint32_t* counter, uint32_t value)
+{
+    uint32_t start = dmosi_get_tick_count();
+    dmosi_mutex_lock(s_mutex);
+    while (*counter < value) {
+        if (s_failures != 0 || dmosi_get_tick_count() - start > 2000) {
+            return false;
+        }
+        dmosi_mutex_unlock(s_mutex);
+        dmosi_thread_sleep(1);
+        dmosi_mutex_lock(s_mutex);
+    }
+    return true;
+}
+
+/**
+ * @brief Broadcast wakes every current waiter even when woken threads wait again at once
+ */
+static int test_broadcast_with_rewaiting_threads(void)
+{
+    dmosi_thread_t threads[WAITERS];
+    for (int i = 0; i < WAITERS; i++) {
+        threads[i] = dmosi_thread_create(rewaiting_thread, NULL, 0, 0, "rewait", NULL);
+        if (threads[i] == NULL) {
+            printf("FAIL: could not create thread %d\n", i);
+            return 1;
+        }
+    }
+
+    bool ok = true;
+    for (int round = 0; round < ROUNDS && ok; round++) {
+        // All waiting in the first wait: release them together
+        ok = wait_for_count(&s_waiting, WAITERS);
+        s_waiting = 0;
+        s_generation++;
+        dmosi_cond_broadcast(s_cond);
+        dmosi_mutex_unlock(s_mutex);
+
+        // All woken, and so all in (or past) the second wait: release that one too
+        ok = ok && wait_for_count(&s_woken, WAITERS);
+        s_woken = 0;
+        s_generation++;
+        dmosi_cond_broadcast(s_cond);
+        dmosi_mutex_unlock(s_mutex);
+    }
+
+    for (int i = 0; i < WAITERS; i++) {
+        dmosi_thread_join(threads[i]);
+        dmosi_thread_destroy(threads[i]);
+    }
+
+    if (!ok || s_failures != 0) {
+        printf("FAIL: broadcast lost %u wakeups\n", (unsigned)s_failures);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief A wait nobody signals times out with the mutex held again
+ */
+static int test_wait_timeout(void)
+{
+    dmosi_mutex_lock(s_mutex);
+    int result = dmosi_cond_wait(s_cond, s_mutex, 20);
+    int unlock_result = dmosi_mutex_unlock(s_mutex);
+    if (result != -ETIMEDOUT || unlock_result != 0) {
+        printf("FAIL: timed wait returned %d, unlock %d\n", result, unlock_result);
+        return 1;
+    }
+
+    // Nothing left queued: a signal now must not wake a later wait
+    dmosi_cond_signal(s_cond);
+    dmosi_mutex_lock(s_mutex);
+    result = dmosi_cond_wait(s_cond, s_mutex, 0);
+    dmosi_mutex_unlock(s_mutex);
+    if (result != -ETIMEDOUT) {
+        printf("FAIL: stale signal woke a later wait (%d)\n", result);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    s_mutex = dmosi_mutex_create(false);
+    s_cond  = dmosi_cond_create();
+    if (s_mutex == NULL || s_cond == NULL) {
+        printf("FAIL: could not create mutex or condition variable\n");
+        return 1;
+    }
+
+    int failures = 0;
+    failures += test_wait_timeout();
+    failures += test_broadcast_with_rewaiting_threads();
+
+    dmosi_cond_destroy(s_cond);
+    dmosi_mutex_destroy(s_mutex);
+
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/*
+ * Tests of the per-thread cache of the current process.
+ *
+ * Built with DMOSI_ENABLE_PROCESS_CACHE; the test backend's
+ * dmosi_process_set_current invalidates the cache, as the option requires.
+ */
+#include <stdio.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+#define SWITCH_ROUNDS   20000
+
+static int          s_process_a;
+static int          s_process_b;
+static dmosi_thread_t s_switcher;
+static uint32_t     s_stop;
+static uint32_t     s_failures;
+
+/**
+ * @brief Moves between two processes, checking the cached lookup follows every move
+ */
+static void switching_thread(void* arg)
+{
+    (void)arg;
+    for (int round = 0; round < SWITCH_ROUNDS; round++) {
+        dmosi_process_t process = (dmosi_process_t)((round & 1) ? &s_process_b : &s_process_a);
+        dmosi_process_set_current(process);
+        if (dmosi_process_current_cached() != process || dmosi_process_current_cached() != process) {
+            dmosi_atomic_fetch_add_u32(&s_failures, 1, DMOSI_MEMORY_ORDER_RELAXED);
+        }
+    }
+    dmosi_atomic_store_u32(&s_stop, 1, DMOSI_MEMORY_ORDER_RELEASE);
+}
+
+/**
+ * @brief Invalidates the switching thread's cache while it is being filled
+ */
+static void invalidating_thread(void* arg)
+{
+    (void)arg;
+    while (dmosi_atomic_load_u32(&s_stop, DMOSI_MEMORY_ORDER_ACQUIRE) == 0) {
+        dmosi_process_invalidate_cached(s_switcher);
+    }
+}
+
+int main(void)
+{
+    dmosi_thread_t invalidator = NULL;
+    s_switcher = dmosi_thread_create(switching_thread, NULL, 0, 0, "switch", (dmosi_process_t)&s_process_a);
+    if (s_switcher != NULL) {
+        invalidator = dmosi_thread_create(invalidating_thread, NULL, 0, 0, "invalidate", NULL);
+    }
+    if (s_switcher == NULL || invalidator == NULL) {
+        printf("FAIL: could not create threads\n");
+        return 1;
+    }
+    dmosi_thread_join(s_switcher);
+    dmosi_thread_join(invalidator);
+    dmosi_thread_destroy(invalidator);
+    dmosi_thread_destroy(s_switcher);
+
+    if (s_failures != 0) {
+        printf("FAIL: cached process stale %u times\n", (unsigned)s_failures);
+    }
+    printf("%s\n", s_failures == 0 ? "PASS" : "FAIL");
+    return s_failures == 0 ? 0 : 1;
+}
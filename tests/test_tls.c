@@ -0,0 +1,192 @@
+/*
+ * Tests of the generic thread-local storage keys.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include "dmod.h"
+#include "dmosi.h"
+
+#define CHURN_THREADS   4
+#define CHURN_ROUNDS    2000
+
+static uint32_t         s_destroyed;        //!< Values passed to count_destructor
+static void*            s_last_destroyed;
+static dmosi_tls_key_t  s_key;
+static void*            s_value;
+static uint32_t         s_churn_key;        //!< Key the churn threads use (atomic)
+static uint32_t         s_stop;
+static uint32_t         s_failures;
+
+static void count_destructor(void* value)
+{
+    dmosi_atomic_fetch_add_u32(&s_destroyed, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    s_last_destroyed = value;
+}
+
+static void wrong_destructor(void* value)
+{
+    printf("FAIL: destructor of a new key called with %p\n", value);
+    dmosi_atomic_fetch_add_u32(&s_failures, 1, DMOSI_MEMORY_ORDER_RELAXED);
+}
+
+/**
+ * @brief Sets s_value for s_key and checks it reads back
+ */
+static void set_value_thread(void* arg)
+{
+    (void)arg;
+    if (dmosi_tls_set(s_key, s_value) != 0 || dmosi_tls_get(s_key) != s_value) {
+        dmosi_atomic_fetch_add_u32(&s_failures, 1, DMOSI_MEMORY_ORDER_RELAXED);
+    }
+}
+
+/**
+ * @brief Leaves a value of a deleted key behind, in the slot of a key with a destructor
+ */
+static void stale_value_thread(void* arg)
+{
+    static int value;
+    dmosi_tls_key_t old_key;
+    dmosi_tls_key_t new_key;
+    (void)arg;
+    dmosi_tls_key_create(&old_key, NULL);
+    dmosi_tls_set(old_key, &value);
+    dmosi_tls_key_delete(old_key);
+    dmosi_tls_key_create(&new_key, wrong_destructor);
+    s_key = new_key;
+}
+
+/**
+ * @brief Run @p entry on a new thread and wait for it
+ */
+static int run_thread(dmosi_thread_entry_t entry, void* arg)
+{
+    dmosi_thread_t thread = dmosi_thread_create(entry, arg, 0, 0, "tls", NULL);
+    if (thread == NULL) {
+        printf("FAIL: could not create thread\n");
+        return 1;
+    }
+    dmosi_thread_join(thread);
+    dmosi_thread_destroy(thread);
+    return 0;
+}
+
+/**
+ * @brief A value is destroyed when its thread exits
+ */
+static int test_destructor_on_exit(void)
+{
+    static int value;
+    if (dmosi_tls_key_create(&s_key, count_destructor) != 0) {
+        printf("FAIL: could not create key\n");
+        return 1;
+    }
+    s_value     = &value;
+    s_destroyed = 0;
+    int failures = run_thread(set_value_thread, NULL);
+    if (s_destroyed != 1 || s_last_destroyed != &value) {
+        printf("FAIL: destructor called %u times\n", (unsigned)s_destroyed);
+        failures++;
+    }
+    dmosi_tls_key_delete(s_key);
+    return failures;
+}
+
+/**
+ * @brief A key that reuses a deleted key's slot doesn't see its values, nor does the deleted key
+ */
+static int test_delete_and_reuse(void)
+{
+    static int value;
+    dmosi_tls_key_t old_key;
+    dmosi_tls_key_t new_key;
+    int failures = 0;
+
+    dmosi_tls_key_create(&old_key, wrong_destructor);
+    dmosi_tls_set(old_key, &value);
+    if (dmosi_tls_key_delete(old_key) != 0 || dmosi_tls_key_delete(old_key) != -EINVAL) {
+        printf("FAIL: deleting a key twice\n");
+        failures++;
+    }
+
+    dmosi_tls_key_create(&new_key, wrong_destructor);
+    if (new_key == old_key) {
+        printf("FAIL: deleted key handed out again\n");
+        failures++;
+    }
+    if (dmosi_tls_get(new_key) != NULL || dmosi_tls_get(old_key) != NULL) {
+        printf("FAIL: stale value visible after delete\n");
+        failures++;
+    }
+    if (dmosi_tls_set(old_key, &value) != -EINVAL) {
+        printf("FAIL: set through a deleted key accepted\n");
+        failures++;
+    }
+
+    dmosi_tls_key_delete(new_key);
+
+    // A stale value must not reach the new key's destructor on thread exit
+    failures += run_thread(stale_value_thread, NULL);
+    dmosi_tls_key_delete(s_key);
+    return failures;
+}
+
+/**
+ * @brief Sets and reads back the current churn key while it is deleted and recreated
+ */
+static void churn_thread(void* arg)
+{
+    int value;
+    (void)arg;
+    while (dmosi_atomic_load_u32(&s_stop, DMOSI_MEMORY_ORDER_ACQUIRE) == 0) {
+        dmosi_tls_key_t key = dmosi_atomic_load_u32(&s_churn_key, DMOSI_MEMORY_ORDER_ACQUIRE);
+        void* before = dmosi_tls_get(key);
+        if (before != NULL && before != &value) {
+            dmosi_atomic_fetch_add_u32(&s_failures, 1, DMOSI_MEMORY_ORDER_RELAXED);
+        }
+        dmosi_tls_set(key, &value);
+    }
+}
+
+/**
+ * @brief Keys are deleted and recreated while other threads use them
+ */
+static int test_churn(void)
+{
+    dmosi_thread_t threads[CHURN_THREADS];
+    dmosi_tls_key_t key;
+    dmosi_tls_key_create(&key, NULL);
+    s_churn_key = key;
+
+    for (int i = 0; i < CHURN_THREADS; i++) {
+        threads[i] = dmosi_thread_create(churn_thread, NULL, 0, 0, "churn", NULL);
+        if (threads[i] == NULL) {
+            printf("FAIL: could not create thread %d\n", i);
+            return 1;
+        }
+    }
+    for (int round = 0; round < CHURN_ROUNDS; round++) {
+        dmosi_tls_key_delete(key);
+        dmosi_tls_key_create(&key, NULL);
+        dmosi_atomic_store_u32(&s_churn_key, key, DMOSI_MEMORY_ORDER_RELEASE);
+    }
+    dmosi_atomic_store_u32(&s_stop, 1, DMOSI_MEMORY_ORDER_RELEASE);
+    for (int i = 0; i < CHURN_THREADS; i++) {
+        dmosi_thread_join(threads[i]);
+        dmosi_thread_destroy(threads[i]);
+    }
+    dmosi_tls_key_delete(key);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+    failures += test_destructor_on_exit();
+    failures += test_delete_and_reuse();
+    failures += test_churn();
+    failures += (int)s_failures;
+
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}